@@ -41,9 +41,9 @@ LinkOptions            :=
 IncludePath            :=  $(IncludeSwitch). $(IncludeSwitch). 
 IncludePCH             := 
 RcIncludePath          := 
-Libs                   := 
-ArLibs                 :=  
-LibPath                := $(LibraryPathSwitch). 
+Libs                   := $(LibrarySwitch)cipherlib 
+ArLibs                 :=  "cipherlib" 
+LibPath                := $(LibraryPathSwitch). $(LibraryPathSwitch)../../cipherlib/$(ConfigurationName) 
 
 ##
 ## Common variables
@@ -74,7 +74,7 @@ Objects=$(Objects0)
 .PHONY: all clean PreBuild PrePreBuild PostBuild MakeIntermediateDirs
 all: $(OutputFile)
 
-$(OutputFile): $(IntermediateDirectory)/.d $(Objects) 
+$(OutputFile): $(IntermediateDirectory)/.d PreBuild $(Objects) 
 	@$(MakeDirCommand) $(@D)
 	@echo "" > $(IntermediateDirectory)/.d
 	@echo $(Objects0)  > $(ObjectsFileList)
@@ -88,6 +88,9 @@ $(IntermediateDirectory)/.d:
 	@test -d $(ConfigurationName) || $(MakeDirCommand) $(ConfigurationName)
 
 PreBuild:
+	@echo Executing Pre Build commands ...
+	$(MAKE) -C ../../cipherlib -f cipherlib.mk ConfigurationName=$(ConfigurationName)
+	@echo Done
 
 
 ##
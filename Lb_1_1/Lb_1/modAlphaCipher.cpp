@@ -1,41 +1,36 @@
 #include "modAlphaCipher.h"
+#include "../../cipherlib/shiftKernel.h"
 #include <locale>
 #include <codecvt>
 #include <iostream>
 
 modAlphaCipher::modAlphaCipher(const std::wstring& skey)
 {
-    // Правильная инициализация alphaNum
-    for (unsigned i = 0; i < numAlpha.size(); i++) {
-        alphaNum[numAlpha[i]] = i;
-    }
     key = convert(skey);
 }
 
 std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
 {
     std::vector<int> work = convert(open_text);
-    for (unsigned i = 0; i < work.size(); i++) {
-        work[i] = (work[i] + key[i % key.size()]) % numAlpha.size();
-    }
+    shiftLetters(work.data(), work.size(), key, false);
     return convert(work);
 }
 
 std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text)
 {
     std::vector<int> work = convert(cipher_text);
-    for (unsigned i = 0; i < work.size(); i++) {
-        work[i] = (work[i] + numAlpha.size() - key[i % key.size()]) % numAlpha.size();
-    }
+    shiftLetters(work.data(), work.size(), key, true);
     return convert(work);
 }
 
 std::vector<int> modAlphaCipher::convert(const std::wstring& s)
 {
     std::vector<int> result;
+    result.reserve(s.size());
     for (auto c : s) {
-        if (alphaNum.find(c) != alphaNum.end()) {
-            result.push_back(alphaNum[c]);
+        int i = alpha.index(c);
+        if (i >= 0) {
+            result.push_back(i);
         }
     }
     return result;
@@ -44,9 +39,10 @@ std::vector<int> modAlphaCipher::convert(const std::wstring& s)
 std::wstring modAlphaCipher::convert(const std::vector<int>& v)
 {
     std::wstring result;
+    result.reserve(v.size());
     for (auto i : v) {
-        if (i >= 0 && i < numAlpha.size()) {
-            result.push_back(numAlpha[i]);
+        if (i >= 0 && i < alphaTable::size) {
+            result.push_back(alpha.numAlpha[i]);
         }
     }
     return result;
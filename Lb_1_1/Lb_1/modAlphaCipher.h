@@ -1,15 +1,14 @@
 #pragma once
+#include "../../cipherlib/alphaTable.h"
 #include <vector>
 #include <string>
-#include <map>
 #include <locale>
 #include <codecvt>
 
 class modAlphaCipher
 {
 private:
-    std::wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
-    std::map<wchar_t, int> alphaNum;
+    static constexpr alphaTable alpha{};
     std::vector<int> key;
     std::vector<int> convert(const std::wstring& s);
     std::wstring convert(const std::vector<int>& v);
@@ -1,4 +1,5 @@
 #include "modAlphaCipher.h"
+#include "../../cipherlib/routePolicy.h"
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -49,87 +50,22 @@ std::wstring modAlphaCipher::toValidText(const std::wstring& s)
     return result;
 }
 
-std::vector<std::vector<wchar_t>> modAlphaCipher::createTable(const std::wstring& text)
-{
-    int len = text.length();
-    int rows = (len + key - 1) / key;
-    
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
-    
-    int pos = 0;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            if (pos < len) {
-                table[i][j] = text[pos++];
-            }
-        }
-    }
-    
-    return table;
-}
-
-std::wstring modAlphaCipher::readTableVertical(const std::vector<std::vector<wchar_t>>& table)
-{
-    std::wstring result;
-    int rows = table.size();
-    int cols = table[0].size();
-    
-    // Считывание сверху вниз, справа налево
-    for (int j = cols - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            if (table[i][j] != L' ') {
-                result.push_back(table[i][j]);
-            }
-        }
-    }
-    
-    return result;
-}
-
-std::wstring modAlphaCipher::readTableHorizontal(const std::vector<std::vector<wchar_t>>& table)
-{
-    std::wstring result;
-    int rows = table.size();
-    int cols = table[0].size();
-    
-    // Считывание по горизонтали слева направо, сверху вниз
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            if (table[i][j] != L' ') {
-                result.push_back(table[i][j]);
-            }
-        }
-    }
-    
-    return result;
-}
-
+// Маршрут: запись по строкам, чтение по столбцам справа налево сверху вниз;
+// пустые ячейки последней строки пропускаются. Перестановка - из cipherlib
 std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
 {
     std::wstring text = toValidText(open_text);
-    std::vector<std::vector<wchar_t>> table = createTable(text);
-    return readTableVertical(table);
+    std::wstring result(text.size(), L' ');
+    route::routeKernel<route::columnsRightToLeft>::apply(text.data(), &result[0], text.size(), size_t(key), false,
+                                                         [](wchar_t) { return true; });
+    return result;
 }
 
 std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text)
 {
     std::wstring text = toValidText(cipher_text);
-    int len = text.length();
-    int rows = (len + key - 1) / key;
-    
-    // Создаем пустую таблицу
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
-    
-    // Заполняем таблицу в порядке считывания (сверху вниз, справа налево)
-    int pos = 0;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            int original_pos = i * key + j;
-            if (original_pos < len && pos < len) {
-                table[i][j] = text[pos++];
-            }
-        }
-    }
-    
-    return readTableHorizontal(table);
-}
\ No newline at end of file
+    std::wstring result(text.size(), L' ');
+    route::routeKernel<route::columnsRightToLeft>::apply(text.data(), &result[0], text.size(), size_t(key), true,
+                                                         [](wchar_t) { return true; });
+    return result;
+}
@@ -20,9 +20,6 @@ private:
     int key;
     int getValidKey(const int k);
     std::wstring toValidText(const std::wstring& s);
-    std::vector<std::vector<wchar_t>> createTable(const std::wstring& text);
-    std::wstring readTableVertical(const std::vector<std::vector<wchar_t>>& table);
-    std::wstring readTableHorizontal(const std::vector<std::vector<wchar_t>>& table);
     
 public:
     modAlphaCipher() = delete;
@@ -3,21 +3,17 @@
 #include <locale>
 #include <codecvt>
 #include <memory>
+#include <system_error>
 #include "modAlphaCipher.h"
 
 using namespace std;
 
-// Функции для конвертации между string и wstring
+// Конвертация string в wstring (для проверки введённого текста)
 std::wstring string_to_wstring(const std::string& str) {
     std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
     return converter.from_bytes(str);
 }
 
-std::string wstring_to_string(const std::wstring& wstr) {
-    std::wstring_convert<std::codecvt_utf8<wchar_t>> converter;
-    return converter.to_bytes(wstr);
-}
-
 bool isValidKey(const string& s) {
     for (char c : s) {
         if (!isdigit(c)) return false;
@@ -60,20 +56,34 @@ public:
         }
     }
     
-    std::wstring encrypt(const std::wstring& text) {
+    std::string encrypt(const std::string& text) {
         if (!cipher) {
             throw cipher_error("Ключ не установлен!");
         }
         return cipher->encrypt(text);
     }
     
-    std::wstring decrypt(const std::wstring& text) {
+    std::string decrypt(const std::string& text) {
         if (!cipher) {
             throw cipher_error("Ключ не установлен!");
         }
         return cipher->decrypt(text);
     }
     
+    void encryptFile(const std::string& input, const std::string& output, bool hugePages) {
+        if (!cipher) {
+            throw cipher_error("Ключ не установлен!");
+        }
+        cipher->encrypt_file(input, output, hugePages);
+    }
+    
+    void decryptFile(const std::string& input, const std::string& output, bool hugePages) {
+        if (!cipher) {
+            throw cipher_error("Ключ не установлен!");
+        }
+        cipher->decrypt_file(input, output, hugePages);
+    }
+    
     int getCurrentKey() const {
         return current_key;
     }
@@ -123,6 +133,30 @@ string inputText(const string& prompt) {
     return text;
 }
 
+// Функция для обработки файла: вход и выход отображаются в память
+void processFile(CipherManager& cipherManager, bool encrypt) {
+    string input, output, huge;
+    cout << "Входной файл: ";
+    getline(cin, input);
+    cout << "Выходной файл: ";
+    getline(cin, output);
+    cout << "Использовать большие страницы (y/n): ";
+    getline(cin, huge);
+    
+    try {
+        if (encrypt) {
+            cipherManager.encryptFile(input, output, huge == "y");
+        } else {
+            cipherManager.decryptFile(input, output, huge == "y");
+        }
+        cout << "Результат записан в " << output << endl;
+    } catch (const cipher_error& e) {
+        cout << "Ошибка при обработке файла: " << e.what() << endl;
+    } catch (const system_error& e) {
+        cout << "Ошибка файла: " << e.what() << endl;
+    }
+}
+
 // Функция для ввода ключа с проверкой
 int inputKey() {
     string key_str;
@@ -172,6 +206,8 @@ int main()
         cout << "1 - Зашифровать текст" << endl;
         cout << "2 - Расшифровать текст" << endl;
         cout << "3 - Сменить ключ" << endl;
+        cout << "4 - Зашифровать файл" << endl;
+        cout << "5 - Расшифровать файл" << endl;
         cout << "Ваш выбор: ";
         cin >> op;
         cin.ignore(); // Очищаем буфер после ввода числа
@@ -181,9 +217,8 @@ int main()
                 string text = inputText("Введите текст для зашифрования: ");
                 
                 try {
-                    wstring wtext = string_to_wstring(text);
-                    wstring encrypted = cipherManager.encrypt(wtext);
-                    cout << "Зашифрованный текст: " << wstring_to_string(encrypted) << endl;
+                    string encrypted = cipherManager.encrypt(text);
+                    cout << "Зашифрованный текст: " << encrypted << endl;
                 } catch (const cipher_error& e) {
                     cout << "Ошибка при шифровании: " << e.what() << endl;
                 }
@@ -194,9 +229,8 @@ int main()
                 string text = inputText("Введите текст для расшифрования: ");
                 
                 try {
-                    wstring wtext = string_to_wstring(text);
-                    wstring decrypted = cipherManager.decrypt(wtext);
-                    cout << "Расшифрованный текст: " << wstring_to_string(decrypted) << endl;
+                    string decrypted = cipherManager.decrypt(text);
+                    cout << "Расшифрованный текст: " << decrypted << endl;
                 } catch (const cipher_error& e) {
                     cout << "Ошибка при расшифровании: " << e.what() << endl;
                 }
@@ -213,6 +247,14 @@ int main()
                 break;
             }
             
+            case 4:
+                processFile(cipherManager, true);
+                break;
+            
+            case 5:
+                processFile(cipherManager, false);
+                break;
+            
             case 0:
                 cout << "Выход из программы." << endl;
                 break;
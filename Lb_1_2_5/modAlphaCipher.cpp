@@ -1,4 +1,7 @@
 #include "modAlphaCipher.h"
+#include "../cipherlib/mappedFile.h"
+#include "../cipherlib/routePolicy.h"
+#include <cstdio>
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -49,87 +52,215 @@ std::wstring modAlphaCipher::toValidText(const std::wstring& s)
     return result;
 }
 
-std::vector<std::vector<wchar_t>> modAlphaCipher::createTable(const std::wstring& text)
+// Позиция буквы k открытого текста в шифртексте: буква стоит в строке k / cols
+// и столбце k % cols; столбцы j < full имеют rows букв, остальные - rows - 1.
+// Столбцы считываются справа налево, сверху вниз.
+static inline size_t routePosition(size_t k, size_t len, size_t cols)
 {
-    int len = text.length();
-    int rows = (len + key - 1) / key;
-    
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
-    
-    int pos = 0;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            if (pos < len) {
-                table[i][j] = text[pos++];
-            }
-        }
-    }
-    
-    return table;
+    size_t rows = (len + cols - 1) / cols;
+    size_t full = len - (rows - 1) * cols;
+    size_t i = k / cols;
+    size_t j = k % cols;
+    return (cols - 1 - j) * (rows - 1) + (full > j + 1 ? full - j - 1 : 0) + i;
 }
 
-std::wstring modAlphaCipher::readTableVertical(const std::vector<std::vector<wchar_t>>& table)
+permutationCache& modAlphaCipher::permutations()
 {
-    std::wstring result;
-    int rows = table.size();
-    int cols = table[0].size();
-    
-    // Считывание сверху вниз, справа налево
-    for (int j = cols - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            if (table[i][j] != L' ') {
-                result.push_back(table[i][j]);
-            }
-        }
-    }
-    
-    return result;
+    static permutationCache cache(16 << 20);
+    return cache;
 }
 
-std::wstring modAlphaCipher::readTableHorizontal(const std::vector<std::vector<wchar_t>>& table)
+// Переставляет буквы одним проходом по маршруту "столбцы справа налево, сверху вниз";
+// для коротких текстов перестановка берется из кэша
+void modAlphaCipher::route(const std::wstring& in, std::wstring& out, bool inverse) const
 {
-    std::wstring result;
-    int rows = table.size();
-    int cols = table[0].size();
-    
-    // Считывание по горизонтали слева направо, сверху вниз
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            if (table[i][j] != L' ') {
-                result.push_back(table[i][j]);
-            }
+    using order = route::columnsRightToLeft;
+    size_t len = in.size();
+    size_t cols = key;
+    if (len <= cachedLength) {
+        permutationCache::map m = permutations().getMap(cols, len, order::id, [&](uint32_t* to) {
+            route::routeMap<order>(to, len, cols);
+        });
+        const uint32_t* to = m->data();
+        for (size_t k = 0; k < len; k++) {
+            if (inverse)
+                out[k] = in[to[k]];
+            else
+                out[to[k]] = in[k];
         }
+        return;
     }
-    
-    return result;
+    route::routeKernel<order>::apply(in.data(), &out[0], len, cols, inverse, [](wchar_t) { return true; });
 }
 
 std::wstring modAlphaCipher::encrypt(const std::wstring& open_text)
 {
     std::wstring text = toValidText(open_text);
-    std::vector<std::vector<wchar_t>> table = createTable(text);
-    return readTableVertical(table);
+    std::wstring result(text.size(), L' ');
+    route(text, result, false);
+    return result;
 }
 
 std::wstring modAlphaCipher::decrypt(const std::wstring& cipher_text)
 {
     std::wstring text = toValidText(cipher_text);
-    int len = text.length();
-    int rows = (len + key - 1) / key;
-    
-    // Создаем пустую таблицу
-    std::vector<std::vector<wchar_t>> table(rows, std::vector<wchar_t>(key, L' '));
-    
-    // Заполняем таблицу в порядке считывания (сверху вниз, справа налево)
-    int pos = 0;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = 0; i < rows; i++) {
-            int original_pos = i * key + j;
-            if (original_pos < len && pos < len) {
-                table[i][j] = text[pos++];
-            }
+    std::wstring result(text.size(), L' ');
+    route(text, result, true);
+    return result;
+}
+
+// Код прописной буквы по её UTF-8 последовательности lead, next: номер символа
+// от U+0400 (Ё - 0x01, А..Я - 0x10..0x2F); -1, если это не русская буква
+static inline int upperCode(unsigned char lead, unsigned char next)
+{
+    if ((next & 0xC0) != 0x80)
+        return -1;
+    int c = next & 0x3F;
+    if (lead == 0xD0 && (c == 0x01 || c >= 0x10))
+        return c >= 0x30 ? c - 0x20 : c;    // Ё, А..Я, а..п
+    if (lead == 0xD1 && c < 0x10)
+        return c + 0x20;                     // р..я
+    if (lead == 0xD1 && c == 0x11)
+        return 0x01;                         // ё
+    return -1;
+}
+
+// Буквы текста кодируются одним байтом в одном буфере, который затем становится
+// результатом: коды пишутся во вторую половину, переставляются в первую и
+// разворачиваются на месте в двухбайтовый UTF-8 (все прописные буквы - D0 xx).
+// Букв не больше n / 2, поэтому буфера out размером с вход хватает.
+size_t modAlphaCipher::routeUtf8(const char* in, size_t n, char* out, bool inverse) const
+{
+    if (n == 0)
+        throw cipher_error(L"Пустой текст");
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    char* codes = out + (n - n / 2);
+    size_t len = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+        int c = upperCode(src[i], src[i + 1]);
+        if (c >= 0) {
+            codes[len++] = static_cast<char>(c);
+            i++;
         }
     }
-    
-    return readTableHorizontal(table);
+    if (len == 0)
+        throw cipher_error(L"В тексте нет русских букв");
+
+    route::routeKernel<route::columnsRightToLeft>::apply(codes, out, len, size_t(key), inverse,
+                                                         [](char) { return true; });
+    for (size_t k = len; k-- > 0;) {
+        out[2 * k + 1] = static_cast<char>(0x80 | out[k]);
+        out[2 * k] = static_cast<char>(0xD0);
+    }
+    return 2 * len;
+}
+
+std::string modAlphaCipher::routeUtf8(const std::string& in, bool inverse) const
+{
+    std::string result(in.size(), '\0');
+    result.resize(routeUtf8(in.data(), in.size(), &result[0], inverse));
+    return result;
+}
+
+void modAlphaCipher::routeFile(const std::string& input, const std::string& output, bool hugePages,
+                               bool inverse) const
+{
+    mappedFile in = mappedFile::openRead(input, hugePages);
+    if (in.size() == 0)
+        throw cipher_error(L"Пустой текст");
+    mappedFile out = mappedFile::create(output, in.size(), hugePages);
+    try {
+        out.resize(routeUtf8(in.data(), in.size(), out.data(), inverse));
+    } catch (const cipher_error&) {
+        out.close();
+        std::remove(output.c_str());
+        throw;
+    }
+    out.close();
+}
+
+std::string modAlphaCipher::encrypt(const std::string& open_text)
+{
+    return routeUtf8(open_text, false);
+}
+
+std::string modAlphaCipher::decrypt(const std::string& cipher_text)
+{
+    return routeUtf8(cipher_text, true);
+}
+
+void modAlphaCipher::encrypt_file(const std::string& input, const std::string& output, bool hugePages)
+{
+    routeFile(input, output, hugePages, false);
+}
+
+void modAlphaCipher::decrypt_file(const std::string& input, const std::string& output, bool hugePages)
+{
+    routeFile(input, output, hugePages, true);
+}
+
+// Приводит русскую букву к верхнему регистру; для прочих символов возвращает 0
+static inline wchar_t upperLetter(wchar_t c)
+{
+    if ((c >= L'А' && c <= L'Я') || c == L'Ё')
+        return c;
+    if (c >= L'а' && c <= L'я')
+        return c - L'а' + L'А';
+    if (c == L'ё')
+        return L'Ё';
+    return 0;
+}
+
+// Подсчитывает буквы текста и проверяет размер буфера
+static cipher_status countLetters(std::wstring_view text, size_t out_size, size_t& len)
+{
+    if (text.empty())
+        return cipher_status::empty_text;
+    len = 0;
+    for (wchar_t c : text)
+        len += upperLetter(c) != 0;
+    if (len == 0)
+        return cipher_status::no_text;
+    if (len > out_size)
+        return cipher_status::small_buffer;
+    return cipher_status::ok;
+}
+
+cipher_result modAlphaCipher::encrypt_into(std::wstring_view open_text, wchar_t* out, size_t out_size) const noexcept
+{
+    size_t len = 0;
+    cipher_status status = countLetters(open_text, out_size, len);
+    if (status != cipher_status::ok)
+        return {0, status};
+
+    size_t k = 0;
+    for (wchar_t c : open_text) {
+        c = upperLetter(c);
+        if (c)
+            out[routePosition(k++, len, key)] = c;
+    }
+    return {len, cipher_status::ok};
+}
+
+cipher_result modAlphaCipher::decrypt_into(std::wstring_view cipher_text, wchar_t* out, size_t out_size) const noexcept
+{
+    size_t len = 0;
+    cipher_status status = countLetters(cipher_text, out_size, len);
+    if (status != cipher_status::ok)
+        return {0, status};
+
+    // Буквы шифртекста идут по столбцам справа налево, сверху вниз
+    size_t cols = key;
+    size_t rows = (len + cols - 1) / cols;
+    size_t full = len - (rows - 1) * cols;
+    auto it = cipher_text.begin();
+    for (size_t j = cols; j-- > 0;) {
+        size_t height = j < full ? rows : rows - 1;
+        for (size_t i = 0; i < height; i++) {
+            while (!upperLetter(*it))
+                ++it;
+            out[i * cols + j] = upperLetter(*it++);
+        }
+    }
+    return {len, cipher_status::ok};
 }
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <string_view>
 #include <locale>
 #include <codecvt>
 #include <stdexcept>
 #include <cwctype>
 #include <iostream>
+#include "../cipherlib/permutationCache.h"
 
 class cipher_error : public std::invalid_argument {
 public:
@@ -13,19 +15,54 @@ public:
     explicit cipher_error(const char* what_arg);
 };
 
+// Код результата операций, не выбрасывающих исключений
+enum class cipher_status {
+    ok,
+    empty_text,   // Пустой текст
+    no_text,      // В тексте нет русских букв
+    small_buffer  // Буфер результата слишком мал
+};
+
+struct cipher_result {
+    size_t size;  // Количество записанных символов (0 при ошибке)
+    cipher_status status;
+};
+
 class modAlphaCipher
 {
 private:
     int key;
     int getValidKey(const int k);
     std::wstring toValidText(const std::wstring& s);
-    std::vector<std::vector<wchar_t>> createTable(const std::wstring& text);
-    std::wstring readTableVertical(const std::vector<std::vector<wchar_t>>& table);
-    std::wstring readTableHorizontal(const std::vector<std::vector<wchar_t>>& table);
+    void route(const std::wstring& in, std::wstring& out, bool inverse) const;
+    std::string routeUtf8(const std::string& in, bool inverse) const;
+    size_t routeUtf8(const char* in, size_t n, char* out, bool inverse) const;
+    void routeFile(const std::string& input, const std::string& output, bool hugePages, bool inverse) const;
     
 public:
     modAlphaCipher() = delete;
     modAlphaCipher(const int k);
     std::wstring encrypt(const std::wstring& open_text);
     std::wstring decrypt(const std::wstring& cipher_text);
+
+    // Варианты для UTF-8 без перехода к wstring: буквы хранятся по одному байту
+    // в буфере результата и переставляются на месте по формуле маршрута
+    std::string encrypt(const std::string& open_text);
+    std::string decrypt(const std::string& cipher_text);
+
+    // Файловый режим: входной и выходной файлы отображаются в память (mappedFile.h),
+    // маршрут применяется прямо к отображениям, выходной файл обрезается до длины
+    // результата. Ошибки ввода-вывода - std::system_error
+    void encrypt_file(const std::string& input, const std::string& output, bool hugePages);
+    void decrypt_file(const std::string& input, const std::string& output, bool hugePages);
+
+    // Запись результата в буфер вызывающей стороны без выделения памяти;
+    // буфера размером с входной текст всегда достаточно
+    cipher_result encrypt_into(std::wstring_view open_text, wchar_t* out, size_t out_size) const noexcept;
+    cipher_result decrypt_into(std::wstring_view cipher_text, wchar_t* out, size_t out_size) const noexcept;
+
+    // Общий кэш перестановок для encrypt/decrypt (по умолчанию до 16 МБ);
+    // перестановки текстов длиннее cachedLength букв не кэшируются
+    static permutationCache& permutations();
+    static const size_t cachedLength = 64 * 1024;
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include <string>
 #include <locale>
 #include <codecvt>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include "modAlphaCipher.h"
 
 using namespace std;
@@ -17,6 +20,23 @@ std::string wstring_to_string(const std::wstring& wstr) {
     return converter.to_bytes(wstr);
 }
 
+// Текст, который должен получиться после расшифрования: только русские буквы в верхнем регистре
+std::wstring lettersOnly(const std::wstring& text) {
+    std::wstring result;
+    for (wchar_t c : text) {
+        if (c >= L'а' && c <= L'я')
+            result.push_back(c - L'а' + L'А');
+        else if (c == L'ё')
+            result.push_back(L'Ё');
+        else if ((c >= L'А' && c <= L'Я') || c == L'Ё')
+            result.push_back(c);
+    }
+    return result;
+}
+
+// Количество непройденных тестов (код возврата программы)
+static int failures = 0;
+
 void runTest(const string& testName, const string& text, int key, bool shouldPass = true) {
     wcout << L"\n=== ТЕСТ: " << string_to_wstring(testName) << L" ===" << endl;
     
@@ -29,18 +49,20 @@ void runTest(const string& testName, const string& text, int key, bool shouldPas
         
         wcout << L"Ключ: " << key << endl;
         wcout << L"Исходный текст: " << string_to_wstring(text) << endl;
-        wcout << L"Зашифрованный: " << wstring_to_string(encrypted) << endl;
-        wcout << L"Расшифрованный: " << wstring_to_string(decrypted) << endl;
+        wcout << L"Зашифрованный: " << encrypted << endl;
+        wcout << L"Расшифрованный: " << decrypted << endl;
         
-        if (wtext == decrypted) {
+        if (lettersOnly(wtext) == decrypted) {
             wcout << L"✅ ТЕСТ ПРОЙДЕН" << endl;
         } else {
             wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: тексты не совпадают" << endl;
+            failures++;
         }
         
     } catch (const cipher_error& e) {
         if (shouldPass) {
             wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: " << e.what() << endl;
+            failures++;
         } else {
             wcout << L"✅ ТЕСТ ПРОЙДЕН (ожидалась ошибка): " << e.what() << endl;
         }
@@ -56,13 +78,93 @@ void runErrorTest(const string& testName, const string& text, int key) {
         wstring encrypted = cipher.encrypt(wtext);
         
         wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: ожидалась ошибка, но шифрование выполнено" << endl;
-        wcout << L"Результат: " << wstring_to_string(encrypted) << endl;
+        wcout << L"Результат: " << encrypted << endl;
+        failures++;
         
     } catch (const cipher_error& e) {
         wcout << L"✅ ТЕСТ ПРОЙДЕН: " << e.what() << endl;
     }
 }
 
+void runIntoTest(const string& testName, const string& text, int key) {
+    wcout << L"\n=== ТЕСТ БУФЕРА: " << string_to_wstring(testName) << L" ===" << endl;
+    
+    modAlphaCipher cipher(key);
+    wstring wtext = string_to_wstring(text);
+    wstring encrypted(wtext.size(), L' ');
+    wstring decrypted(wtext.size(), L' ');
+    cipher_result e = cipher.encrypt_into(wtext, &encrypted[0], encrypted.size());
+    encrypted.resize(e.size);
+    cipher_result d = cipher.decrypt_into(encrypted, &decrypted[0], decrypted.size());
+    decrypted.resize(d.size);
+    
+    if (e.status == cipher_status::ok && encrypted == cipher.encrypt(wtext) && decrypted == cipher.decrypt(encrypted)) {
+        wcout << L"✅ ТЕСТ ПРОЙДЕН" << endl;
+    } else {
+        wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: результаты не совпадают" << endl;
+        failures++;
+    }
+}
+
+void runCacheTest(const string& testName, const string& text, int key) {
+    wcout << L"\n=== ТЕСТ КЭША: " << string_to_wstring(testName) << L" ===" << endl;
+    
+    modAlphaCipher::permutations().clear();
+    modAlphaCipher cipher(key);
+    wstring wtext = string_to_wstring(text);
+    wstring first = cipher.encrypt(wtext);
+    wstring second = cipher.encrypt(wtext);
+    wstring decrypted = cipher.decrypt(first);
+    permutationCache::stats s = modAlphaCipher::permutations().statistics();
+    
+    if (first == second && decrypted == cipher.decrypt(second) && s.misses == 1 && s.hits == 2) {
+        wcout << L"✅ ТЕСТ ПРОЙДЕН" << endl;
+    } else {
+        wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: попаданий " << s.hits << L", промахов " << s.misses << endl;
+        failures++;
+    }
+}
+
+void runUtf8Test(const string& testName, const string& text, int key) {
+    wcout << L"\n=== ТЕСТ UTF-8: " << string_to_wstring(testName) << L" ===" << endl;
+    
+    modAlphaCipher cipher(key);
+    wstring wtext = string_to_wstring(text);
+    string encrypted = cipher.encrypt(text);
+    string decrypted = cipher.decrypt(encrypted);
+    
+    if (encrypted == wstring_to_string(cipher.encrypt(wtext)) &&
+        decrypted == wstring_to_string(cipher.decrypt(cipher.encrypt(wtext)))) {
+        wcout << L"✅ ТЕСТ ПРОЙДЕН" << endl;
+    } else {
+        wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: результаты UTF-8 и wstring не совпадают" << endl;
+        failures++;
+    }
+}
+
+void runFileTest(const string& testName, const string& text, int key) {
+    wcout << L"\n=== ТЕСТ ФАЙЛА: " << string_to_wstring(testName) << L" ===" << endl;
+    
+    modAlphaCipher cipher(key);
+    ofstream("route_in.tmp", ios::binary) << text;
+    cipher.encrypt_file("route_in.tmp", "route_out.tmp", false);
+    ifstream enc("route_out.tmp", ios::binary);
+    string encrypted((istreambuf_iterator<char>(enc)), istreambuf_iterator<char>());
+    cipher.decrypt_file("route_out.tmp", "route_back.tmp", true);
+    ifstream dec("route_back.tmp", ios::binary);
+    string decrypted((istreambuf_iterator<char>(dec)), istreambuf_iterator<char>());
+    remove("route_in.tmp");
+    remove("route_out.tmp");
+    remove("route_back.tmp");
+    
+    if (encrypted == cipher.encrypt(text) && decrypted == cipher.decrypt(encrypted)) {
+        wcout << L"✅ ТЕСТ ПРОЙДЕН" << endl;
+    } else {
+        wcout << L"❌ ТЕСТ НЕ ПРОЙДЕН: результаты файла и строки не совпадают" << endl;
+        failures++;
+    }
+}
+
 int main()
 {
     setlocale(LC_ALL, "ru_RU.UTF-8");
@@ -76,13 +178,30 @@ int main()
     runTest("Текст со знаками", "Привет, мир!", 3);
     runTest("Только русские буквы", "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", 5);
     
+    // Тесты записи в буфер
+    runIntoTest("Буфер: простой текст", "ПРИВЕТ", 3);
+    runIntoTest("Буфер: текст со знаками", "Привет, мир! Ёлка", 4);
+    runIntoTest("Буфер: ключ длиннее текста", "МИР", 7);
+    
+    // Тесты кэша перестановок
+    runCacheTest("Кэш: повтор длины", "Привет, мир!", 3);
+    
+    // Тесты UTF-8 без перехода к wstring
+    runUtf8Test("UTF-8: текст со знаками", "Привет, мир! Ёлка ёж", 3);
+    runUtf8Test("UTF-8: ключ длиннее текста", "мир", 7);
+    runUtf8Test("UTF-8: другие алфавиты", "Ђ ѐ € abc ТЕКСТ", 2);
+    
+    // Тесты файлового режима
+    runFileTest("Файл: текст со знаками", "Привет, мир! Ёлка ёж", 3);
+    runFileTest("Файл: ключ длиннее текста", "мир", 7);
+    
     // Тесты ошибок
     runErrorTest("Пустой текст", "", 3);
     runErrorTest("Текст без букв", "12345!@#$", 3);
     runErrorTest("Нулевой ключ", "ТЕКСТ", 0);
     runErrorTest("Отрицательный ключ", "ТЕКСТ", -5);
     
-    wcout << L"\n=== ТЕСТИРОВАНИЕ ЗАВЕРШЕНО ===" << endl;
+    wcout << L"\n=== ТЕСТИРОВАНИЕ ЗАВЕРШЕНО: не пройдено " << failures << L" ===" << endl;
     
-    return 0;
+    return failures ? 1 : 0;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "modAlphaCipher.h"
+#include "../../cipherlib/shiftKernel.h"
 #include <iostream>
 #include <algorithm>
 
@@ -9,40 +10,38 @@ wstring_convert<codecvt_utf8<wchar_t>, wchar_t> codec;
 
 modAlphaCipher::modAlphaCipher(const wstring& skey)
 {
-    for(unsigned i = 0; i < numAlpha.size(); i++)
-        alphaNum[numAlpha[i]] = i;
     key = convert(getValidKey(skey));
 }
 
 wstring modAlphaCipher::encrypt(const wstring& open_text)
 {
     vector<int> work = convert(getValidOpenText(open_text));
-    for(unsigned i = 0; i < work.size(); i++)
-        work[i] = (work[i] + key[i % key.size()]) % alphaNum.size();
+    shiftLetters(work.data(), work.size(), key, false);
     return convert(work);
 }
 
 wstring modAlphaCipher::decrypt(const wstring& cipher_text)
 {
     vector<int> work = convert(getValidCipherText(cipher_text));
-    for(unsigned i = 0; i < work.size(); i++)
-        work[i] = (work[i] + alphaNum.size() - key[i % key.size()]) % alphaNum.size();
+    shiftLetters(work.data(), work.size(), key, true);
     return convert(work);
 }
 
 vector<int> modAlphaCipher::convert(const wstring& s)
 {
     vector<int> result;
+    result.reserve(s.size());
     for(auto c : s)
-        result.push_back(alphaNum[c]);
+        result.push_back(alpha.index(c));
     return result;
 }
 
 wstring modAlphaCipher::convert(const vector<int>& v)
 {
     wstring result;
+    result.reserve(v.size());
     for(auto i : v)
-        result.push_back(numAlpha[i]);
+        result.push_back(alpha.numAlpha[i]);
     return result;
 }
 
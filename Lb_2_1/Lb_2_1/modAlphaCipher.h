@@ -1,5 +1,5 @@
 #pragma once
-#include <map>
+#include "../../cipherlib/alphaTable.h"
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -10,8 +10,7 @@ using namespace std;
 class modAlphaCipher
 {
 private:
-    wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
-    map<wchar_t, int> alphaNum;
+    static constexpr alphaTable alpha{};
     vector<int> key;
     vector<int> convert(const wstring& s);
     wstring convert(const vector<int>& v);
@@ -37,7 +37,7 @@ PreprocessOnlySwitch   :=-E
 ObjectsFileList        :="Lb_2_2.txt"
 PCHCompileFlags        :=
 MakeDirCommand         :=mkdir -p
-LinkOptions            :=  
+LinkOptions            :=  -pthread
 IncludePath            :=  $(IncludeSwitch). $(IncludeSwitch). 
 IncludePCH             := 
 RcIncludePath          := 
@@ -1,5 +1,9 @@
 #include "TableRouteCipher.h"
+#include "../../cipherlib/mappedFile.h"
+#include "../../cipherlib/routePolicy.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
@@ -7,86 +11,176 @@ Cipher::Cipher(int skey, string text) {
     key = getValidKey(skey, text);
 }
 
+Cipher::Cipher(int skey) {
+    if (skey < 2)
+        throw cipher_error("Некорректный размер ключа");
+    key = skey;
+}
+
+// Перестановка по маршруту без построения таблицы: rows = ceil(n / key) строк,
+// столбцы читаются справа налево снизу вверх, пустые ячейки последней строки
+// пропускаются. Записанные символы проверяются предикатом valid в том же проходе.
+template <class F>
+static bool routeCopy(const char* in, char* out, size_t n, size_t key, bool inverse, F valid) {
+    return route::routeKernel<route::columnsBottomUp>::apply(in, out, n, key, inverse, valid);
+}
+
+// То же в threads потоков по полосам строк таблицы
+template <class F>
+static bool routeCopyParallel(const char* in, char* out, size_t n, size_t key, bool inverse, unsigned threads,
+                              F valid) {
+    return route::routeParallel<route::columnsBottomUp>(in, out, n, key, inverse, valid, threads);
+}
+
+size_t Cipher::parallelThreshold = 4 << 20;
+
+static inline bool isLatin(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static inline bool anyChar(char) {
+    return true;
+}
+
+// Позиция в зашифрованном тексте символа k открытого текста (та же перестановка, что в routeCopy)
+static size_t routePosition(size_t k, size_t n, size_t key) {
+    size_t rows = (n + key - 1) / key;
+    size_t top = rows - 1;
+    size_t full = n - top * key;
+    size_t i = k / key;
+    size_t j = k % key;
+    if (j >= full)
+        return (key - 1 - j) * top + top - 1 - i;
+    return (key - full) * top + (full - 1 - j) * rows + top - i;
+}
+
 string Cipher::encryption(string& text) {
     string t = getValidOpenText(text);
-    int length = t.size();
-    
-    // Расчет количества строк
-    int rows = (length + key - 1) / key;
-    
-    // Создание таблицы
-    vector<vector<char>> table(rows, vector<char>(key, ' '));
-    
-    // Заполнение таблицы по строкам слева направо
-    int index = 0;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            if (index < length) {
-                table[i][j] = t[index++];
-            }
-        }
-    }
-    
-    // Чтение по спирали: СНИЗУ ВВЕРХ по столбцам СПРАВА НАЛЕВО
-    string result;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = rows - 1; i >= 0; i--) {
-            if (table[i][j] != ' ') {
-                result += table[i][j];
-            }
-        }
-    }
-    
+    string result(t.size(), ' ');
+    routeCopy(t.data(), &result[0], t.size(), key, false, anyChar);
     return result;
 }
 
 string Cipher::transcript(string& text, string& open_text) {
     string t = getValidCipherText(text, open_text);
-    int length = t.size();
-    
-    // Расчет количества строк
-    int rows = (length + key - 1) / key;
-    
-    // Создание таблицы
-    vector<vector<char>> table(rows, vector<char>(key, ' '));
-    
-    // Определяем количество пустых ячеек в последней строке
-    int empty_cells = rows * key - length;
-    
-    // Заполнение таблицы в обратном порядке шифрования
-    int index = 0;
-    for (int j = key - 1; j >= 0; j--) {
-        for (int i = rows - 1; i >= 0; i--) {
-            // Пропускаем пустые ячейки в последней строке
-            if (i == rows - 1 && j >= key - empty_cells) {
-                continue;
-            }
-            if (index < length) {
-                table[i][j] = t[index++];
-            }
+    string result(t.size(), ' ');
+    routeCopy(t.data(), &result[0], t.size(), key, true, anyChar);
+
+    // Пробелы в таблице считались пустыми ячейками и в результат не попадали
+    result.erase(remove(result.begin(), result.end(), ' '), result.end());
+    return result;
+}
+
+// Расшифрование только по ключу: размер таблицы выводится из длины текста,
+// символы проверяются во время перестановки
+string Cipher::transcript(const string& text) {
+    if (text.empty())
+        throw cipher_error("Отсутствует зашифрованный текст");
+    string result(text.size(), ' ');
+    if (!routeCopy(text.data(), &result[0], text.size(), key, true, isLatin))
+        throw cipher_error("Некорректные символы в зашифрованном тексте. Разрешены только латинские буквы (A-Z, a-z).");
+    return result;
+}
+
+string Cipher::encryption(string& text, unsigned threads) {
+    text.erase(remove(text.begin(), text.end(), ' '), text.end());
+    if (text.empty())
+        throw cipher_error("Отсутствует открытый текст");
+    if (text.size() < parallelThreshold)
+        threads = 1;
+    string result(text.size(), ' ');
+    // Символы проверяются в полосах, без отдельного прохода
+    if (!routeCopyParallel(text.data(), &result[0], text.size(), key, false, threads, isLatin))
+        throw cipher_error("Некорректные символы в строке. Разрешены только латинские буквы (A-Z, a-z).");
+    return result;
+}
+
+string Cipher::transcript(const string& text, unsigned threads) {
+    if (text.empty())
+        throw cipher_error("Отсутствует зашифрованный текст");
+    if (text.size() < parallelThreshold)
+        threads = 1;
+    string result(text.size(), ' ');
+    if (!routeCopyParallel(text.data(), &result[0], text.size(), key, true, threads, isLatin))
+        throw cipher_error("Некорректные символы в зашифрованном тексте. Разрешены только латинские буквы (A-Z, a-z).");
+    return result;
+}
+
+void Cipher::encryptionFile(const string& input, const string& output, unsigned threads, bool hugePages) {
+    mappedFile in = mappedFile::openRead(input, hugePages);
+    auto encrypt = [&](const char* text, size_t n) {
+        if (n == 0)
+            throw cipher_error("Отсутствует открытый текст");
+        if (n < parallelThreshold)
+            threads = 1;
+        mappedFile out = mappedFile::create(output, n, hugePages);
+        if (!routeCopyParallel(text, out.data(), n, key, false, threads, isLatin)) {
+            out.close();
+            remove(output.c_str());
+            throw cipher_error("Некорректные символы в строке. Разрешены только латинские буквы (A-Z, a-z).");
         }
+        out.close();
+    };
+    // Текст без пробелов переставляется прямо из отображения
+    if (in.size() == 0 || !memchr(in.data(), ' ', in.size())) {
+        encrypt(in.data(), in.size());
+        return;
     }
-    
-    // Чтение по строкам слева направо
-    string result;
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < key; j++) {
-            if (table[i][j] != ' ') {
-                result += table[i][j];
-            }
-        }
+    // Пробелы удаляются во второй отображённый файл рядом с выходным, а не в копию
+    // в памяти: для больших файлов она удвоила бы расход памяти
+    string compactPath = output + ".compact";
+    mappedFile compact = mappedFile::create(compactPath, in.size(), hugePages);
+    size_t n = remove_copy(in.data(), in.data() + in.size(), compact.data(), ' ') - compact.data();
+    in.close();
+    try {
+        encrypt(compact.data(), n);
+    } catch (...) {
+        compact.resize(0);
+        compact.close();
+        remove(compactPath.c_str());
+        throw;
     }
-    
-    return result;
+    compact.resize(0);
+    compact.close();
+    remove(compactPath.c_str());
+}
+
+void Cipher::transcriptFile(const string& input, const string& output, unsigned threads, bool hugePages) {
+    mappedFile in = mappedFile::openRead(input, hugePages);
+    size_t n = in.size();
+    if (n == 0)
+        throw cipher_error("Отсутствует зашифрованный текст");
+    if (n < parallelThreshold)
+        threads = 1;
+    mappedFile out = mappedFile::create(output, n, hugePages);
+    if (!routeCopyParallel(in.data(), out.data(), n, key, true, threads, isLatin)) {
+        out.close();
+        remove(output.c_str());
+        throw cipher_error("Некорректные символы в зашифрованном тексте. Разрешены только латинские буквы (A-Z, a-z).");
+    }
+    out.close();
+}
+
+void Cipher::encryptionInPlace(string& text) {
+    getValidOpenText(text);
+    size_t n = text.size();
+    permuteInPlace(&text[0], n, [&](size_t k) { return routePosition(k, n, key); }, false);
+}
+
+void Cipher::transcriptInPlace(string& text, string& open_text) {
+    getValidCipherText(text, open_text);
+    size_t n = text.size();
+    permuteInPlace(&text[0], n, [&](size_t k) { return routePosition(k, n, key); }, true);
+    text.erase(remove(text.begin(), text.end(), ' '), text.end());
 }
 
-inline string Cipher::getValidCipherText(string& s, string& open_text) {
+inline string& Cipher::getValidCipherText(string& s, string& open_text) {
     if (s.empty())
         throw cipher_error("Отсутствует зашифрованный текст");
     return s;
 }
 
-inline string Cipher::getValidOpenText(string& s) {
+inline string& Cipher::getValidOpenText(string& s) {
     // Удаляем пробелы
     s.erase(remove(s.begin(), s.end(), ' '), s.end());
 
@@ -17,13 +17,35 @@ class Cipher {
 private:
     int key;
     inline int getValidKey(int key, const string& Text);
-    inline string getValidOpenText(string& s);
-    inline string getValidCipherText(string& s, string& open_text);
+    inline string& getValidOpenText(string& s);
+    inline string& getValidCipherText(string& s, string& open_text);
     bool isValidUTF8Char(const string& str, size_t& pos);
 
 public:
     Cipher() = delete;
     Cipher(int skey, string text);
+    // Ключ без текста (для файлового режима): длина текста заранее неизвестна,
+    // поэтому проверяется только, что в таблице не меньше двух столбцов
+    explicit Cipher(int skey);
     string encryption(string& text);
     string transcript(string& text, string& open_text);
+    // Расшифрование без открытого текста
+    string transcript(const string& text);
+    // Многопоточные варианты: полосы строк таблицы разбираются потоками из общей
+    // очереди; тексты короче parallelThreshold обрабатываются в вызывающем потоке
+    string encryption(string& text, unsigned threads);
+    string transcript(const string& text, unsigned threads);
+    static size_t parallelThreshold;
+    // Варианты на месте: вместо копии текста нужен битовый массив из n / 8 байт
+    void encryptionInPlace(string& text);
+    void transcriptInPlace(string& text, string& open_text);
+    // Файловый режим: входной и выходной файлы отображаются в память (mappedFile.h),
+    // перестановка идёт прямо между отображениями. Результат совпадает с
+    // encryption(text, threads) / transcript(text, threads) для содержимого файла,
+    // в том числе для файла короче ключа; при ошибке в тексте выходной файл удаляется.
+    // Если во входном файле есть пробелы, encryptionFile сначала удаляет их во временный
+    // файл output + ".compact" того же размера (тоже отображённый, с hugePages), поэтому
+    // на диске нужно место ещё на одну копию входа
+    void encryptionFile(const string& input, const string& output, unsigned threads, bool hugePages);
+    void transcriptFile(const string& input, const string& output, unsigned threads, bool hugePages);
 };
\ No newline at end of file
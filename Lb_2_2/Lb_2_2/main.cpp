@@ -1,6 +1,7 @@
 #include <iostream>
 #include "TableRouteCipher.h"
 #include <limits>
+#include <system_error>
 
 using namespace std;
 
@@ -56,6 +57,41 @@ void decryptText() {
     }
 }
 
+void processFile() {
+    int mode;
+    string input, output, huge;
+    int key;
+    
+    cout << "Режим (1 - зашифровать, 2 - расшифровать): ";
+    cin >> mode;
+    
+    cout << "Входной файл: ";
+    cin.ignore();
+    getline(cin, input);
+    
+    cout << "Выходной файл: ";
+    getline(cin, output);
+    
+    cout << "Введите ключ: ";
+    cin >> key;
+    
+    cout << "Использовать большие страницы (y/n): ";
+    cin >> huge;
+    
+    try {
+        Cipher cipher(key);
+        if (mode == 1)
+            cipher.encryptionFile(input, output, 0, huge == "y");
+        else
+            cipher.transcriptFile(input, output, 0, huge == "y");
+        cout << "Результат записан в " << output << endl;
+    } catch (const cipher_error & e) {
+        cerr << "Ошибка: " << e.what() << endl;
+    } catch (const system_error & e) {
+        cerr << "Ошибка файла: " << e.what() << endl;
+    }
+}
+
 void testExamples() {
     cout << "=== ТЕСТОВЫЕ ПРИМЕРЫ ===" << endl;
     
@@ -101,6 +137,7 @@ void showMenu() {
          << "║ 2. Расшифровать текст               ║\n"
          << "║ 3. Показать тестовые примеры        ║\n"
          << "║ 4. Инструкция                       ║\n"
+         << "║ 5. Обработать файл                  ║\n"
          << "║ 0. Выход                            ║\n"
          << "╚══════════════════════════════════════╝\n"
          << "Выберите действие: ";
@@ -148,6 +185,9 @@ int main() {
             case 4:
                 showInstructions();
                 break;
+            case 5:
+                processFile();
+                break;
             case 0:
                 cout << "Спасибо за использование программы! До свидания!" << endl;
                 break;
@@ -1,5 +1,8 @@
 #include <UnitTest++/UnitTest++.h>
 #include "modAlphaCipher.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 // Простые тесты которые точно работают
 SUITE(KeyTest)
@@ -118,6 +121,43 @@ SUITE(DecryptTest)
     }
 }
 
+SUITE(ThreadTest)
+{
+    // Один объект шифра общий для всех потоков
+    TEST(SharedCipher) {
+        modAlphaCipher cipher("КЛЮЧ");
+        std::vector<std::string> texts;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 8; i++) {
+            std::string text;
+            for (int j = 0; j <= i * 50; j++)
+                text += j % 3 ? "ёжик в тумане, " : "ПРИВЕТ мир ";
+            texts.push_back(text);
+            expected.push_back(cipher.encrypt(text));
+        }
+        std::atomic<int> failures(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; t++)
+            workers.emplace_back([&, t] {
+                for (int n = 0; n < 100; n++) {
+                    size_t i = (t * 3 + n) % texts.size();
+                    std::string encrypted = cipher.encrypt(texts[i]);
+                    if (encrypted != expected[i] || cipher.encrypt(cipher.decrypt(encrypted)) != encrypted)
+                        failures++;
+                }
+            });
+        for (auto& w : workers)
+            w.join();
+        CHECK_EQUAL(0, failures.load());
+    }
+
+    TEST(CopiedCipher) {
+        modAlphaCipher cipher("КЛЮЧ");
+        modAlphaCipher copy = cipher;
+        CHECK_EQUAL(cipher.encrypt("ПРИВЕТ"), copy.encrypt("ПРИВЕТ"));
+    }
+}
+
 int main(int argc, char **argv)
 {
     return UnitTest::RunAllTests();
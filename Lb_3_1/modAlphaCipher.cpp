@@ -1,13 +1,62 @@
 #include "modAlphaCipher.h"
-#include <locale>
-#include <codecvt>
+#include "../cipherlib/shiftKernel.h"
 #include <iostream>
+#include <stdexcept>
 
-std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> codec;
+// Разбор UTF-8 без wstring_convert: функции не хранят состояния, поэтому один
+// объект шифра можно вызывать из нескольких потоков. Ошибки - как у codecvt_utf8
+static std::wstring fromUtf8(const std::string& s) {
+    std::wstring ws;
+    ws.reserve(s.size());
+    for (size_t i = 0; i < s.size();) {
+        unsigned char b = s[i];
+        size_t len = b < 0x80 ? 1 : b < 0xC2 ? 0 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF5 ? 4 : 0;
+        if (len == 0)
+            throw std::range_error("wstring_convert::from_bytes");
+        if (i + len > s.size())
+            break; // Оборванный последний символ codecvt_utf8 тоже отбрасывает
+        unsigned long c = len == 1 ? b : b & (0x7F >> len);
+        for (size_t k = 1; k < len; k++) {
+            unsigned char t = s[i + k];
+            if ((t & 0xC0) != 0x80)
+                throw std::range_error("wstring_convert::from_bytes");
+            c = (c << 6) | (t & 0x3F);
+        }
+        if ((len == 3 && c < 0x800) || (len == 4 && (c < 0x10000 || c > 0x10FFFF)))
+            throw std::range_error("wstring_convert::from_bytes");
+        ws.push_back(static_cast<wchar_t>(c));
+        i += len;
+    }
+    return ws;
+}
+
+static std::string toUtf8(const std::wstring& ws) {
+    std::string s;
+    s.reserve(2 * ws.size());
+    for (wchar_t wc : ws) {
+        unsigned long c = static_cast<unsigned long>(wc);
+        if (c < 0x80) {
+            s.push_back(static_cast<char>(c));
+        } else if (c < 0x800) {
+            s.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            s.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            s.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            s.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c <= 0x10FFFF) {
+            s.push_back(static_cast<char>(0xF0 | (c >> 18)));
+            s.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            s.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            s.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            throw std::range_error("wstring_convert::to_bytes");
+        }
+    }
+    return s;
+}
 
 modAlphaCipher::modAlphaCipher(const std::string& skey) {
-    for (unsigned i=0; i < numAlpha.size(); i++)
-        alphaNum[numAlpha[i]]=i;
     key = convert(getValidKey(skey));
     
     if (key.size() > 1) {
@@ -25,36 +74,36 @@ modAlphaCipher::modAlphaCipher(const std::string& skey) {
 
 std::string modAlphaCipher::encrypt(const std::string& open_text) {
     std::vector<int> work = convert(getValidOpenText(open_text));
-    for(unsigned i=0; i < work.size(); i++)
-        work[i] = (work[i] + key[i % key.size()]) % alphaNum.size();
+    shiftLetters(work.data(), work.size(), key, false);
     return convert(work);
 }
 
 std::string modAlphaCipher::decrypt(const std::string& cipher_text) {
     std::vector<int> work = convert(getValidCipherText(cipher_text));
-    for(unsigned i=0; i < work.size(); i++)
-        work[i] = (work[i] + alphaNum.size() - key[i % key.size()]) % alphaNum.size();
+    shiftLetters(work.data(), work.size(), key, true);
     return convert(work);
 }
 
 std::vector<int> modAlphaCipher::convert(const std::string& s) {
-    std::wstring ws = codec.from_bytes(s);
+    std::wstring ws = fromUtf8(s);
     std::vector<int> result;
+    result.reserve(ws.size());
     for(auto c:ws)
-        result.push_back(alphaNum[c]);
+        result.push_back(alpha.index(c));
     return result;
 }
 
 std::string modAlphaCipher::convert(const std::vector<int>& v) {
     std::wstring ws;
+    ws.reserve(v.size());
     for(auto i:v)
-        ws.push_back(numAlpha[i]);
-    std::string result = codec.to_bytes(ws);
+        ws.push_back(alpha.numAlpha[i]);
+    std::string result = toUtf8(ws);
     return result;
 }
 
 std::string modAlphaCipher::getValidKey(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
+    std::wstring ws = fromUtf8(s);
     if (ws.empty())
         throw cipher_error("Пустой ключ");
     
@@ -66,12 +115,12 @@ std::string modAlphaCipher::getValidKey(const std::string & s) {
             c -= 32;
     }
     
-    std::string mp = codec.to_bytes(tmp);
+    std::string mp = toUtf8(tmp);
     return mp;
 }
 
 std::string modAlphaCipher::getValidOpenText(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
+    std::wstring ws = fromUtf8(s);
     std::wstring tmp;
     
     for (auto c:ws) {
@@ -86,12 +135,12 @@ std::string modAlphaCipher::getValidOpenText(const std::string & s) {
     if (tmp.empty())
         throw cipher_error("Отсутствует открытый текст!"); 
     
-    std::string mp = codec.to_bytes(tmp);
+    std::string mp = toUtf8(tmp);
     return mp;
 }
 
 std::string modAlphaCipher::getValidCipherText(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
+    std::wstring ws = fromUtf8(s);
     
     if (ws.empty())
         throw cipher_error("Empty cipher text");
@@ -101,6 +150,6 @@ std::string modAlphaCipher::getValidCipherText(const std::string & s) {
             throw cipher_error("Неправильный зашифрованный текст!");
     }
     
-    std::string mp = codec.to_bytes(ws);
+    std::string mp = toUtf8(ws);
     return mp;
 }
\ No newline at end of file
@@ -1,7 +1,15 @@
+/**
+ * @file modAlphaCipher.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Заголовочный файл для модуля шифрования методом Гронсфельда
+ */
+
 #pragma once
+#include "../cipherlib/alphaTable.h"
 #include <vector>
 #include <string>
-#include <map>
 #include <stdexcept>
 #include <locale>
 #include <codecvt>
@@ -14,10 +22,14 @@ class cipher_error: public std::invalid_argument {
         std::invalid_argument(what_arg) {}
 };
 
+/**
+ * @class modAlphaCipher
+ * @brief Класс для шифрования и расшифрования текста методом Гронсфельда
+ * @details Использует алфавит из 33 прописных русских букв (alphaTable)
+ */
 class modAlphaCipher {
     private:
-        std::wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
-        std::map<wchar_t,int> alphaNum;
+        static constexpr alphaTable alpha{};
         std::vector<int> key;
         std::vector<int> convert(const std::string& s);
         std::string convert(const std::vector<int>& v);
@@ -30,37 +42,3 @@ class modAlphaCipher {
         std::string encrypt(const std::string& open_text);
         std::string decrypt(const std::string& cipher_text);
 };
-
-/**
- * @file modAlphaCipher.h
- * @author Никита Седнёв
- * @version 1.0
- * @date 2025-11-27
- * @brief Заголовочный файл для модуля шифрования методом Гронсфельда
- */
-
-/**
- * @class modAlphaCipher
- * @brief Класс для шифрования и расшифрования текста методом Гронсфельда
- * @details Использует алфавит из прописных английских букв
- */
-class modAlphaCipher {
-    // ...
-public:
-    /**
-     * @brief Конструктор с ключом
-     * @param skey Ключ в виде строки
-     * @throw cipher_error Если ключ пустой или содержит недопустимые символы
-     */
-    modAlphaCipher(const std::string& skey);
-
-    /**
-     * @brief Шифрует открытый текст
-     * @param open_text Текст для шифрования
-     * @return Зашифрованная строка
-     * @throw cipher_error Если текст пустой
-     */
-    std::string encrypt(const std::string& open_text);
-
-    // Аналогично для decrypt и других методов
-};
\ No newline at end of file
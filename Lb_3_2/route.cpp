@@ -1,4 +1,13 @@
 #include "route.h"
+#include "../cipherlib/routePolicy.h"
+
+// Перестановка по маршруту из cipherlib: столбцы таблицы из n / key полных строк
+// читаются справа налево сверху вниз, символы за последней полной строкой
+// остаются на местах (в out они уже скопированы)
+static void routeCopy(const char* in, char* out, size_t n, size_t key, bool inverse) {
+    size_t rows = n / key;
+    route::routeKernel<route::columnsRightToLeft>::apply(in, out, rows * key, key, inverse, [](char) { return true; });
+}
 
 code::code(int skey, string text) {
     key = getValidKey(skey, text);
@@ -6,33 +15,9 @@ code::code(int skey, string text) {
 
 string code::encryption(const string& text) {
     string t = getValidOpenText(text);
-    int k = 0;
-    int simvoli = t.size();
-    int stroki = simvoli / key;
-    char** tabl = new char* [stroki];
-    for (int i = 0; i < stroki; i++)
-        tabl[i] = new char [key];
-
-    for (int i = 0; i < stroki; i++)
-        for (int j = 0; j < key; j++) {
-            if(k < simvoli) {
-                tabl[i][j] = t[k];
-                k++;
-            }
-        }
-
-    k = 0;
-    for (int j = key - 1; j >= 0 ; j--)
-        for (int i = 0; i < stroki; i++) {
-            t[k] = tabl[i][j];
-            k++;
-        }
-
-    for (int i = 0; i < stroki; i++)
-        delete[] tabl[i];
-    delete[] tabl;
-
-    return t;
+    string result = t;
+    routeCopy(t.data(), &result[0], t.size(), key, false);
+    return result;
 }
 
 string code::transcript(const string& text, const string& open_text) {
@@ -53,31 +38,9 @@ string code::transcript(const string& text, const string& open_text) {
     }
 
     string t = getValidCipherText(text, open_text);
-    int k = 0;
-    int simvoli = t.size();
-    int stroki = simvoli / key;
-    char** tabl = new char* [stroki];
-    for (int i = 0; i < stroki; i++)
-        tabl[i] = new char [key];
-
-    for (int j = key - 1; j >= 0 ; j--)
-        for (int i = 0; i < stroki; i++) {
-            tabl[i][j] = t[k];
-            k++;
-        }
-
-    k = 0;
-    for (int i = 0; i < stroki; i++)
-        for (int j = 0; j < key; j++) {
-            t[k] = tabl[i][j];
-            k++;
-        }
-
-    for (int i = 0; i < stroki; i++)
-        delete[] tabl[i];
-    delete[] tabl;
-
-    return t;
+    string result = t;
+    routeCopy(t.data(), &result[0], t.size(), key, true);
+    return result;
 }
 
 inline string code::getValidCipherText(const string& s, const string& open_text) {
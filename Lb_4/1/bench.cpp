@@ -0,0 +1,235 @@
+/**
+ * @file bench.cpp
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Замер производительности класса modAlphaCipher
+ * @details Сравнивает поиск номера буквы через std::map (прежняя реализация)
+ *          с плотной таблицей alphaTable, измеряет скорость encrypt/decrypt
+ *          (в том числе многопоточных, пакетных, на общем объекте из 1..64 потоков и с ключом,
+ *          известным на этапе компиляции), составной шифр productCipher против
+ *          последовательного применения шифра и перестановки
+ *          и ядра сдвига на 1 КБ, 1 МБ и 1 ГБ для каждого набора инструкций.
+ *          Сборка: g++ -std=c++17 -O2 bench.cpp modAlphaCIpher.cpp productCipher.cpp ../../cipherlib/shiftKernel.cpp -o bench -pthread
+ *          Запуск: ./bench [размер текста] [максимальный размер для ядра] [--stats]
+ *          С --stats (и сборкой с -DCIPHER_STATS) в конце печатается статистика этапов шифров.
+ */
+
+#include "modAlphaCipher.h"
+#include "productCipher.h"
+#include "../../cipherlib/cipherStats.h"
+#include "../../cipherlib/shiftKernel.h"
+#include "staticAlphaCipher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Формирует русский текст заданного размера в UTF-8
+ * @param bytes Желаемый размер в байтах
+ * @return Текст из прописных и строчных букв с пробелами
+ */
+static std::string makeText(size_t bytes)
+{
+    const std::string sample = "Съешь же ещё этих мягких французских булок, да выпей чаю ";
+    std::string text;
+    text.reserve(bytes + sample.size());
+    while (text.size() < bytes)
+        text += sample;
+    text.resize(bytes);
+    while (!text.empty() && (static_cast<unsigned char>(text.back()) & 0xC0) == 0x80)
+        text.pop_back();
+    if (!text.empty() && static_cast<unsigned char>(text.back()) >= 0xC0)
+        text.pop_back();
+    return text;
+}
+
+/**
+ * @brief Маршрутная перестановка code (Lab 4.2) над двухбайтовыми буквами шифртекста
+ * @details Второй проход при последовательном применении шифров: отдельный буфер
+ *          результата и чтение столбцов таблицы справа налево.
+ * @param s Текст из двухбайтовых букв
+ * @param key Количество столбцов
+ * @param inverse true - обратная перестановка
+ * @return Переставленный текст
+ */
+static std::string routeLetters(const std::string& s, size_t key, bool inverse)
+{
+    std::string out = s;
+    size_t rows = s.size() / 2 / key;
+    for (size_t k = 0; k < rows * key; k++) {
+        size_t p = (key - 1 - k % key) * rows + k / key;
+        size_t from = inverse ? p : k, to = inverse ? k : p;
+        out[2 * to] = s[2 * from];
+        out[2 * to + 1] = s[2 * from + 1];
+    }
+    return out;
+}
+
+/**
+ * @brief Измеряет время выполнения функции
+ * @param f Замеряемая функция
+ * @return Время в секундах
+ */
+template <class F>
+static double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+/**
+ * @brief Выводит строку результата
+ * @param name Название замера
+ * @param bytes Объём обработанных данных
+ * @param seconds Время
+ */
+static void report(const char* name, size_t bytes, double seconds)
+{
+    std::cout << name << ": " << bytes / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+/// Ключ шаблонного шифра, совпадающий с ключом замеряемого объекта
+static constexpr char benchKey[] = "ПАРОЛЬ";
+
+int main(int argc, char** argv)
+{
+    // --stats допускается в любом месте, остальные аргументы позиционные
+    bool stats = false;
+    int args = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--stats")
+            stats = true;
+        else
+            argv[args++] = argv[i];
+    }
+    argc = args;
+    size_t bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8u << 20;
+    std::wstring letters;
+    for (size_t i = 0; i < bytes / 2; i++)
+        letters.push_back(modAlphaCipher::alpha.numAlpha[i % alphaTable::size]);
+
+    // Прежний способ: std::map<wchar_t,int> в каждом экземпляре
+    std::map<wchar_t, int> alphaNum;
+    for (int i = 0; i < alphaTable::size; i++)
+        alphaNum[modAlphaCipher::alpha.numAlpha[i]] = i;
+
+    long sumMap = 0, sumTable = 0;
+    double tMap = measure([&] {
+        for (auto c : letters)
+            sumMap += alphaNum[c];
+    });
+    double tTable = measure([&] {
+        for (auto c : letters)
+            sumTable += modAlphaCipher::alpha.index(c);
+    });
+    if (sumMap != sumTable) {
+        std::cerr << "Результаты поиска не совпадают" << std::endl;
+        return 1;
+    }
+    report("lookup std::map", letters.size() * 2, tMap);
+    report("lookup alphaTable", letters.size() * 2, tTable);
+
+    modAlphaCipher cipher("ПАРОЛЬ");
+    std::string text = makeText(bytes);
+    std::string encrypted;
+    report("encrypt", text.size(), measure([&] { encrypted = cipher.encrypt(text); }));
+    report("decrypt", encrypted.size(), measure([&] { cipher.decrypt(encrypted); }));
+    report("static encrypt", text.size(), measure([&] { staticAlphaCipher<benchKey>::encrypt(text); }));
+    report("static decrypt", encrypted.size(), measure([&] { staticAlphaCipher<benchKey>::decrypt(encrypted); }));
+    for (unsigned threads = 2; threads <= std::max(2u, std::thread::hardware_concurrency()); threads *= 2) {
+        std::string suffix = " " + std::to_string(threads) + " threads";
+        report(("encrypt" + suffix).c_str(), text.size(), measure([&] { cipher.encrypt(text, threads); }));
+        report(("decrypt" + suffix).c_str(), encrypted.size(), measure([&] { cipher.decrypt(encrypted, threads); }));
+    }
+
+    // Составной шифр: один проход против шифрования и перестановки по очереди
+    for (int routeKey : {16, 1024}) {
+        productCipher product("ПАРОЛЬ", routeKey);
+        std::string chained, fused, chainedPlain, fusedPlain;
+        double tChain = measure([&] { chained = routeLetters(cipher.encrypt(text), routeKey, false); });
+        double tFused = measure([&] { fused = product.encrypt(text); });
+        double tChainDec = measure([&] { chainedPlain = cipher.decrypt(routeLetters(chained, routeKey, true)); });
+        double tFusedDec = measure([&] { fusedPlain = product.decrypt(fused); });
+        if (chained != fused || chainedPlain != fusedPlain) {
+            std::cerr << "Результаты составного шифра не совпадают" << std::endl;
+            return 1;
+        }
+        std::string suffix = " route " + std::to_string(routeKey);
+        report(("chained encrypt" + suffix).c_str(), text.size(), tChain);
+        report(("fused encrypt" + suffix).c_str(), text.size(), tFused);
+        report(("chained decrypt" + suffix).c_str(), fused.size(), tChainDec);
+        report(("fused decrypt" + suffix).c_str(), fused.size(), tFusedDec);
+    }
+
+    // Миллион коротких сообщений: по одному и пакетом
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 1000000; i++)
+        messages.push_back(makeText(40 + i % 360));
+    std::vector<std::string_view> views(messages.begin(), messages.end());
+    size_t messageBytes = 0;
+    for (auto& m : messages)
+        messageBytes += m.size();
+    report("encrypt per message", messageBytes, measure([&] {
+        for (auto& m : messages)
+            cipher.encrypt(m);
+    }));
+    cipher_batch batch;
+    cipher.encrypt_batch(views.data(), views.size(), batch); // буферы пакета выделяются один раз
+    report("encrypt_batch", messageBytes, measure([&] { cipher.encrypt_batch(views.data(), views.size(), batch); }));
+
+    // Один общий объект, вызываемый одновременно из 1..64 потоков
+    const modAlphaCipher& shared = cipher;
+    std::string sample = makeText(64 * 1024);
+    for (unsigned threads = 1; threads <= 64; threads *= 2) {
+        const size_t calls = 256;
+        double t = measure([&] {
+            std::vector<std::thread> workers;
+            for (unsigned w = 0; w < threads; w++)
+                workers.emplace_back([&] {
+                    std::string out(sample.size(), '\0');
+                    for (size_t n = 0; n < calls; n++)
+                        shared.encrypt_into(sample, &out[0], out.size());
+                });
+            for (auto& w : workers)
+                w.join();
+        });
+        std::string name = "shared encrypt_into " + std::to_string(threads) + " threads";
+        report(name.c_str(), sample.size() * calls * threads, t);
+    }
+
+    // Ядро сдвига на упакованных номерах букв
+    size_t maxKernel = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : size_t(1) << 30;
+    std::vector<int> key = {15, 0, 17, 15, 12, 29};
+    std::vector<unsigned char> stream = makeKeyStream(key, false);
+    const std::pair<shiftLevel, const char*> levels[] = {
+        {shiftLevel::scalar, "scalar"}, {shiftLevel::sse42, "sse4.2"}, {shiftLevel::avx2, "avx2"}};
+    for (size_t size : {size_t(1) << 10, size_t(1) << 20, size_t(1) << 30}) {
+        if (size > maxKernel)
+            break;
+        std::vector<unsigned char> data(size);
+        for (size_t i = 0; i < size; i++)
+            data[i] = i % alphaTable::size;
+        size_t repeat = std::max<size_t>(1, (size_t(64) << 20) / size);
+        for (auto& level : levels) {
+            if (!shiftLevelSupported(level.first))
+                continue;
+            double t = measure([&] {
+                for (size_t r = 0; r < repeat; r++)
+                    shiftAdd(data.data(), size, stream.data(), key.size(), r % key.size(), level.first);
+            });
+            std::string name = std::string("shift ") + level.second + " " + std::to_string(size) + " B";
+            report(name.c_str(), size * repeat, t);
+        }
+    }
+    if (stats)
+        cipherStats::print(std::cout, cipherStats::take());
+    return 0;
+}
@@ -8,7 +8,24 @@
  */
 
 #include <UnitTest++/UnitTest++.h>
+#include "../../cipherlib/allocationTracker.h"
 #include "modAlphaCipher.h"
+#include "productCipher.h"
+#include "../../cipherlib/shiftKernel.h"
+#include "staticAlphaCipher.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 /// Тесты для конструктора и ключа
 SUITE(KeyTest)
@@ -130,6 +147,668 @@ SUITE(DecryptTest)
     }
 }
 
+/// Тесты таблиц алфавита
+SUITE(AlphabetTest)
+{
+    TEST(LetterIndexes) {
+        CHECK_EQUAL(0, modAlphaCipher::alpha.index(L'А'));
+        CHECK_EQUAL(6, modAlphaCipher::alpha.index(L'Ё'));
+        CHECK_EQUAL(7, modAlphaCipher::alpha.index(L'Ж'));
+        CHECK_EQUAL(32, modAlphaCipher::alpha.index(L'Я'));
+    }
+
+    TEST(NonLetterIndexes) {
+        CHECK_EQUAL(-1, modAlphaCipher::alpha.index(L'а'));
+        CHECK_EQUAL(-1, modAlphaCipher::alpha.index(L'ё'));
+        CHECK_EQUAL(-1, modAlphaCipher::alpha.index(L'Z'));
+        CHECK_EQUAL(-1, modAlphaCipher::alpha.index(L' '));
+    }
+
+    TEST(RoundTripTable) {
+        for (int i = 0; i < alphaTable::size; i++)
+            CHECK_EQUAL(i, modAlphaCipher::alpha.index(modAlphaCipher::alpha.numAlpha[i]));
+    }
+
+    TEST(KnownCipherText) {
+        modAlphaCipher cipher("КЛЮЧ");
+        CHECK_EQUAL("ЪЬЖЩПЮКАЫЭШЬГЗЕЬПЕЫЙУБКЦНЦЖМЯЬЮЕБЯЁИХФУШЮЧМВ",
+                    cipher.encrypt("Привет, мир! Съешь же ещё этих мягких французских булок"));
+        CHECK_EQUAL("ЫЪБП", cipher.decrypt("ЁЁЯЖ"));
+    }
+}
+
+/// Тесты однопроходной обработки UTF-8
+SUITE(Utf8Test)
+{
+    TEST_FIXTURE(SimpleFixture, MixedScripts) {
+        CHECK_EQUAL(p->encrypt("ПРИВЕТ"), p->encrypt("Hello, ПРИ€вет 😀!"));
+    }
+
+    TEST_FIXTURE(SimpleFixture, YoIsSkippedInOpenText) {
+        CHECK_EQUAL(p->encrypt("ЕЖ"), p->encrypt("ЕЁёЖ"));
+    }
+
+    TEST_FIXTURE(SimpleFixture, YoInCipherText) {
+        std::string decrypted = p->decrypt("ЁЁЁЁ");
+        CHECK_EQUAL("ЁЁЁЁ", p->encrypt(decrypted));
+    }
+
+    TEST_FIXTURE(SimpleFixture, TruncatedSequence) {
+        CHECK_THROW(p->encrypt(std::string("ТЕСТ") + '\xD0'), cipher_error);
+        CHECK_THROW(p->decrypt(std::string("ТЕСТ") + '\xD0'), cipher_error);
+    }
+
+    TEST_FIXTURE(SimpleFixture, InvalidLeadByte) {
+        CHECK_THROW(p->encrypt(std::string("\x80ТЕСТ")), cipher_error);
+    }
+}
+
+/// Тесты ядра сдвига
+SUITE(ShiftKernelTest)
+{
+    TEST(LevelsMatchScalar) {
+        const shiftLevel levels[] = {shiftLevel::sse42, shiftLevel::avx2};
+        for (size_t keyLen : {1, 2, 3, 7, 16, 31, 33, 40}) {
+            std::vector<int> key;
+            for (size_t i = 0; i < keyLen; i++)
+                key.push_back((i * 11 + 5) % alphaTable::size);
+            for (bool inverse : {false, true}) {
+                std::vector<unsigned char> stream = makeKeyStream(key, inverse);
+                for (size_t phase = 0; phase < keyLen; phase += 3) {
+                    std::vector<unsigned char> expected(1000);
+                    for (size_t i = 0; i < expected.size(); i++)
+                        expected[i] = (i * 7) % alphaTable::size;
+                    std::vector<unsigned char> data = expected;
+                    shiftAdd(expected.data(), expected.size(), stream.data(), keyLen, phase, shiftLevel::scalar);
+                    for (shiftLevel level : levels) {
+                        if (!shiftLevelSupported(level))
+                            continue;
+                        std::vector<unsigned char> work = data;
+                        shiftAdd(work.data(), work.size(), stream.data(), keyLen, phase, level);
+                        CHECK(work == expected);
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(InverseStreamRestores) {
+        std::vector<int> key = {0, 32, 16, 1};
+        std::vector<unsigned char> enc = makeKeyStream(key, false);
+        std::vector<unsigned char> dec = makeKeyStream(key, true);
+        std::vector<unsigned char> data(100);
+        for (size_t i = 0; i < data.size(); i++)
+            data[i] = i % alphaTable::size;
+        std::vector<unsigned char> work = data;
+        shiftAdd(work.data(), work.size(), enc.data(), key.size(), 2);
+        shiftAdd(work.data(), work.size(), dec.data(), key.size(), 2);
+        CHECK(work == data);
+    }
+
+    TEST_FIXTURE(SimpleFixture, LongTextRoundTrip) {
+        std::string text;
+        for (int i = 0; i < 5000; i++)
+            text += "ЁЖИК";
+        std::string encrypted = p->encrypt(text);
+        CHECK_EQUAL(text.size() - 5000 * 2, encrypted.size());
+        CHECK_EQUAL(p->encrypt(p->decrypt(encrypted)), encrypted);
+    }
+}
+
+/// Тесты потокового шифрования
+SUITE(StreamTest)
+{
+    /// Прогоняет текст через поток частями заданного размера
+    std::string streamed(modAlphaStream& stream, const std::string& text, size_t part) {
+        std::string result;
+        for (size_t i = 0; i < text.size(); i += part)
+            result += stream.update(text.substr(i, part));
+        return result + stream.finish();
+    }
+
+    TEST_FIXTURE(SimpleFixture, EncryptAnySplit) {
+        std::string text = "Съешь же ещё этих мягких французских булок, да выпей чаю 😀!";
+        modAlphaStream stream(*p, modAlphaStream::encryption);
+        for (size_t part = 1; part <= text.size(); part++)
+            CHECK_EQUAL(p->encrypt(text), streamed(stream, text, part));
+    }
+
+    TEST_FIXTURE(SimpleFixture, DecryptAnySplit) {
+        std::string text = p->encrypt("Съешь же ещё этих мягких французских булок");
+        modAlphaStream stream(*p, modAlphaStream::decryption);
+        for (size_t part = 1; part <= text.size(); part++)
+            CHECK_EQUAL(p->decrypt(text), streamed(stream, text, part));
+    }
+
+    TEST_FIXTURE(SimpleFixture, KeyPhaseCarried) {
+        modAlphaStream stream(*p, modAlphaStream::encryption);
+        std::string result = stream.update("ПРИ");
+        result += stream.update("ВЕТ");
+        stream.finish();
+        CHECK_EQUAL(p->encrypt("ПРИВЕТ"), result);
+    }
+
+    TEST_FIXTURE(SimpleFixture, TruncatedAtFinish) {
+        modAlphaStream stream(*p, modAlphaStream::encryption);
+        stream.update(std::string("ТЕСТ") + '\xD0');
+        CHECK_THROW(stream.finish(), cipher_error);
+    }
+
+    TEST_FIXTURE(SimpleFixture, NoLetters) {
+        modAlphaStream stream(*p, modAlphaStream::encryption);
+        stream.update("123 ");
+        stream.update("!?");
+        CHECK_THROW(stream.finish(), cipher_error);
+    }
+
+    TEST_FIXTURE(SimpleFixture, BadCipherChunk) {
+        modAlphaStream stream(*p, modAlphaStream::decryption);
+        CHECK_THROW(stream.update("ПРИ ВЕТ"), cipher_error);
+    }
+}
+
+#ifdef __linux__
+/**
+ * @brief На время жизни объекта ограничивает адресное пространство процесса
+ * @details Предел - текущий размер плюс spare байт, меньше стека нового потока,
+ *          поэтому запуск потока завершается std::system_error
+ */
+class addressSpaceLimit {
+    rlimit saved;
+public:
+    explicit addressSpaceLimit(size_t spare) {
+        getrlimit(RLIMIT_AS, &saved);
+        size_t pages = 0;
+        std::ifstream("/proc/self/statm") >> pages;
+        rlimit limited = saved;
+        limited.rlim_cur = pages * sysconf(_SC_PAGESIZE) + spare;
+        setrlimit(RLIMIT_AS, &limited);
+    }
+    ~addressSpaceLimit() {
+        setrlimit(RLIMIT_AS, &saved);
+    }
+};
+#endif
+
+/// Тесты многопоточного шифрования
+SUITE(ParallelTest)
+{
+    /// Текст, достаточный для разбиения на несколько частей
+    std::string bigText() {
+        std::string text;
+        while (text.size() < 8 * modAlphaCipher::minParallelBytes)
+            text += "Съешь же ещё этих мягких французских булок, да выпей чаю 😀! ";
+        return text;
+    }
+
+    TEST_FIXTURE(SimpleFixture, EncryptMatchesSequential) {
+        std::string text = bigText();
+        std::string expected = p->encrypt(text);
+        for (unsigned threads : {0u, 1u, 2u, 3u, 7u, 8u, 64u})
+            CHECK(expected == p->encrypt(text, threads));
+    }
+
+    TEST_FIXTURE(SimpleFixture, DecryptMatchesSequential) {
+        std::string encrypted = p->encrypt(bigText());
+        std::string expected = p->decrypt(encrypted);
+        for (unsigned threads : {0u, 1u, 2u, 3u, 7u, 8u, 64u})
+            CHECK(expected == p->decrypt(encrypted, threads));
+    }
+
+    TEST_FIXTURE(SimpleFixture, ErrorInWorker) {
+        std::string encrypted = p->encrypt(bigText());
+        encrypted[encrypted.size() - 2] = 'A';
+        CHECK_THROW(p->decrypt(encrypted, 4), cipher_error);
+        std::string text = bigText();
+        text[text.size() / 2] = '\xFF';
+        CHECK_THROW(p->encrypt(text, 4), cipher_error);
+    }
+
+#ifdef __linux__
+    TEST_FIXTURE(SimpleFixture, ThreadStartFailure) {
+        std::string text = bigText();
+        std::string expected = p->encrypt(text);
+        std::string encrypted;
+        {
+            // Места хватает на результат, но не на стеки всех потоков
+            addressSpaceLimit limit(4 << 20);
+            encrypted = p->encrypt(text, 8);
+        }
+        CHECK(expected == encrypted);
+    }
+#endif
+
+    TEST_FIXTURE(SimpleFixture, NoLettersParallel) {
+        CHECK_THROW(p->encrypt(std::string(8 * modAlphaCipher::minParallelBytes, '1'), 4), cipher_error);
+    }
+}
+
+/// Тесты записи в буфер вызывающей стороны
+SUITE(IntoTest)
+{
+    TEST_FIXTURE(SimpleFixture, EncryptInto) {
+        std::string text = "Привет, мир!";
+        char out[64];
+        cipher_result r = p->encrypt_into(text, out, sizeof out);
+        CHECK(r.status == cipher_status::ok);
+        CHECK_EQUAL(p->encrypt(text), std::string(out, r.size));
+    }
+
+    TEST_FIXTURE(SimpleFixture, DecryptInto) {
+        std::string text = p->encrypt("ПРИВЕТМИР");
+        char out[64];
+        cipher_result r = p->decrypt_into(text, out, sizeof out);
+        CHECK(r.status == cipher_status::ok);
+        CHECK_EQUAL("ПРИВЕТМИР", std::string(out, r.size));
+    }
+
+    TEST_FIXTURE(SimpleFixture, ErrorCodes) {
+        char out[8];
+        CHECK(p->encrypt_into("123", out, sizeof out).status == cipher_status::no_text);
+        CHECK(p->encrypt_into("ПРИВЕТМИР", out, sizeof out).status == cipher_status::small_buffer);
+        CHECK(p->encrypt_into("\xD0", out, sizeof out).status == cipher_status::bad_encoding);
+        CHECK(p->decrypt_into("", out, sizeof out).status == cipher_status::empty_text);
+        CHECK(p->decrypt_into("АБ В", out, sizeof out).status == cipher_status::invalid_text);
+        CHECK(p->decrypt_into("ПРИВЕТ", out, 4).status == cipher_status::small_buffer);
+    }
+
+    TEST_FIXTURE(SimpleFixture, NoAllocations) {
+        std::string text;
+        for (int i = 0; i < 10000; i++)
+            text += "Съешь же ещё этих мягких булок! ";
+        std::string encrypted(text.size(), '\0');
+        std::string decrypted(text.size(), '\0');
+        allocationScope scope;
+        cipher_result e = p->encrypt_into(text, &encrypted[0], encrypted.size());
+        cipher_result d = p->decrypt_into(std::string_view(encrypted.data(), e.size), &decrypted[0], decrypted.size());
+        p->encrypt_into("123", &encrypted[0], encrypted.size());
+        p->decrypt_into("АБ В", &decrypted[0], decrypted.size());
+        CHECK_EQUAL(size_t(0), scope.allocations());
+        CHECK(e.status == cipher_status::ok);
+        CHECK(d.status == cipher_status::ok);
+        CHECK_EQUAL(p->encrypt(text), encrypted.substr(0, e.size));
+    }
+}
+
+/// Тесты пакетной обработки сообщений
+SUITE(BatchTest)
+{
+    TEST_FIXTURE(SimpleFixture, MatchesSingleCalls) {
+        std::string_view texts[] = {"Привет", "мир", "Съешь же ещё этих булок"};
+        cipher_batch batch;
+        p->encrypt_batch(texts, 3, batch);
+        CHECK_EQUAL(3u, batch.size());
+        for (size_t i = 0; i < 3; i++) {
+            CHECK(batch.status[i] == cipher_status::ok);
+            CHECK_EQUAL(p->encrypt(std::string(texts[i])), std::string(batch[i]));
+        }
+        CHECK_EQUAL(batch.arena.size(), batch.offsets[3]);
+    }
+
+    TEST_FIXTURE(SimpleFixture, ErrorsInStatus) {
+        std::string_view texts[] = {"ПРИВЕТ", "", "ПРИ ВЕТ", "ЁЖ"};
+        cipher_batch batch;
+        p->decrypt_batch(texts, 4, batch);
+        CHECK(batch.status[0] == cipher_status::ok);
+        CHECK(batch.status[1] == cipher_status::empty_text);
+        CHECK(batch.status[2] == cipher_status::invalid_text);
+        CHECK(batch.status[3] == cipher_status::ok);
+        CHECK(batch[1].empty());
+        CHECK(batch[2].empty());
+        CHECK_EQUAL(p->decrypt("ПРИВЕТ"), std::string(batch[0]));
+        CHECK_EQUAL(p->decrypt("ЁЖ"), std::string(batch[3]));
+    }
+
+    TEST_FIXTURE(SimpleFixture, NoLettersInStatus) {
+        std::string_view texts[] = {"123", "ТЕКСТ"};
+        cipher_batch batch;
+        p->encrypt_batch(texts, 2, batch);
+        CHECK(batch.status[0] == cipher_status::no_text);
+        CHECK(batch.status[1] == cipher_status::ok);
+        CHECK_EQUAL(p->encrypt("ТЕКСТ"), std::string(batch[1]));
+    }
+
+    TEST_FIXTURE(SimpleFixture, EmptyBatch) {
+        cipher_batch batch;
+        p->encrypt_batch(nullptr, 0, batch);
+        CHECK_EQUAL(0u, batch.size());
+        CHECK_EQUAL(0u, batch.offsets[0]);
+    }
+
+    TEST_FIXTURE(SimpleFixture, ReuseWithoutAllocations) {
+        std::vector<std::string_view> texts(1000, "Съешь же ещё этих мягких французских булок");
+        cipher_batch batch;
+        p->encrypt_batch(texts.data(), texts.size(), batch);
+        allocationScope scope;
+        p->encrypt_batch(texts.data(), texts.size(), batch);
+        CHECK_EQUAL(size_t(0), scope.allocations());
+        CHECK_EQUAL(p->encrypt(std::string(texts[0])), std::string(batch[999]));
+    }
+}
+
+/// Тесты одновременного использования одного объекта из нескольких потоков
+SUITE(ConcurrencyTest)
+{
+    TEST(SharedCipherStress) {
+        const modAlphaCipher cipher("ПАРОЛЬ");
+        std::vector<std::string> texts;
+        std::vector<std::string> expected;
+        for (int i = 0; i < 32; i++) {
+            std::string text;
+            for (int j = 0; j <= i * 37; j++)
+                text += j % 5 ? "ёжик в тумане, " : "Привет 😀 ";
+            texts.push_back(text);
+            expected.push_back(cipher.encrypt(text));
+        }
+        std::atomic<int> failures(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 16; t++)
+            workers.emplace_back([&, t] {
+                for (int n = 0; n < 200; n++) {
+                    size_t i = (t * 7 + n) % texts.size();
+                    std::string encrypted = cipher.encrypt(texts[i]);
+                    if (encrypted != expected[i] || cipher.encrypt(cipher.decrypt(encrypted)) != encrypted)
+                        failures++;
+                    std::string out(texts[i].size(), '\0');
+                    cipher_result r = cipher.encrypt_into(texts[i], &out[0], out.size());
+                    if (out.compare(0, r.size, expected[i]) != 0)
+                        failures++;
+                }
+            });
+        for (auto& w : workers)
+            w.join();
+        CHECK_EQUAL(0, failures.load());
+    }
+
+    TEST(ConcurrentConstruction) {
+        std::atomic<int> failures(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; t++)
+            workers.emplace_back([&] {
+                for (int n = 0; n < 500; n++) {
+                    modAlphaCipher cipher("Ключ");
+                    if (cipher.decrypt(cipher.encrypt("ПРИВЕТ")) != "ПРИВЕТ")
+                        failures++;
+                    try {
+                        modAlphaCipher bad("К1");
+                        failures++;
+                    } catch (const cipher_error&) {
+                    }
+                }
+            });
+        for (auto& w : workers)
+            w.join();
+        CHECK_EQUAL(0, failures.load());
+    }
+}
+
+/// Ключи для шаблонного шифра (массивы со статическим временем жизни)
+static constexpr char keyKlyuch[] = "КЛЮЧ";
+static constexpr char keyLower[] = "ключ";
+static constexpr char keyParol[] = "ПАРОЛЬ";
+
+/// Тесты для шифра с ключом, известным на этапе компиляции
+SUITE(StaticCipherTest)
+{
+    constexpr auto literal = staticAlphaCipher<keyKlyuch>::encrypt("Привет, мир!");
+    static_assert(literal.view() == "ЪЬЖЩПЮКАЫ", "шифрование литерала на этапе компиляции");
+    static_assert(staticAlphaCipher<keyKlyuch>::decrypt("ЪЬЖЩПЮКАЫ").view() == "ПРИВЕТМИР",
+                  "расшифрование литерала на этапе компиляции");
+    static_assert(staticAlphaCipher<keyLower>::period == 4, "длина ключа в буквах");
+
+    TEST(ScheduleMatchesKey) {
+        CHECK_EQUAL(11, staticAlphaCipher<keyKlyuch>::encSchedule[0]);
+        CHECK_EQUAL(31, staticAlphaCipher<keyKlyuch>::encSchedule[2]);
+        CHECK_EQUAL(22, staticAlphaCipher<keyKlyuch>::decSchedule[0]);
+    }
+
+    TEST(LiteralMatchesRuntime) {
+        modAlphaCipher cipher("КЛЮЧ");
+        CHECK_EQUAL(cipher.encrypt("Привет, мир!"), std::string(literal.view()));
+    }
+
+    TEST(LowerCaseKey) {
+        CHECK_EQUAL(staticAlphaCipher<keyKlyuch>::encrypt(std::string_view("ТЕСТ")),
+                    staticAlphaCipher<keyLower>::encrypt(std::string_view("ТЕСТ")));
+    }
+
+    TEST(RuntimeMatchesDynamic) {
+        modAlphaCipher cipher("ПАРОЛЬ");
+        std::string text;
+        for (int i = 0; i < 3000; i++)
+            text += "Съешь же ещё этих мягких французских булок! ";
+        std::string encrypted = staticAlphaCipher<keyParol>::encrypt(text);
+        CHECK_EQUAL(cipher.encrypt(text), encrypted);
+        CHECK_EQUAL(cipher.decrypt(encrypted), staticAlphaCipher<keyParol>::decrypt(encrypted));
+    }
+
+    TEST(CipherWithYo) {
+        CHECK_EQUAL(modAlphaCipher("КЛЮЧ").decrypt("ЁЖЁ"), staticAlphaCipher<keyKlyuch>::decrypt(std::string_view("ЁЖЁ")));
+    }
+
+    TEST(NoLetters) {
+        CHECK_THROW(staticAlphaCipher<keyKlyuch>::encrypt(std::string_view("123 !?")), cipher_error);
+    }
+
+    TEST(EmptyCipherText) {
+        CHECK_THROW(staticAlphaCipher<keyKlyuch>::decrypt(std::string_view("")), cipher_error);
+    }
+
+    TEST(InvalidCipherText) {
+        CHECK_THROW(staticAlphaCipher<keyKlyuch>::decrypt(std::string_view("Привет")), cipher_error);
+        CHECK_THROW(staticAlphaCipher<keyKlyuch>::decrypt("ПРИ ВЕТ"), cipher_error);
+    }
+}
+
+/// Тесты составного шифра (Гронсфельд и маршрутная перестановка)
+SUITE(ProductTest)
+{
+    TEST(MatchesChain) {
+        productCipher product("КЛЮЧ", 3);
+        CHECK_EQUAL("ЪЬЖЩПЮКАЫ", modAlphaCipher("КЛЮЧ").encrypt("ПРИВЕТМИР"));
+        CHECK_EQUAL("ЖЮЫЬПАЪЩК", product.encrypt("ПРИВЕТМИР"));
+        CHECK_EQUAL("ЖЮЫЬПАЪЩК", product.encrypt("привет, мир"));
+        CHECK_EQUAL("ПРИВЕТМИР", product.decrypt("ЖЮЫЬПАЪЩК"));
+    }
+
+    TEST(TailStaysInPlace) {
+        productCipher product("КЛЮЧ", 4);
+        std::string substituted = modAlphaCipher("КЛЮЧ").encrypt("ПРИВЕТМИРЫ");
+        std::string encrypted = product.encrypt("ПРИВЕТМИРЫ");
+        CHECK_EQUAL(substituted.substr(16), encrypted.substr(16));
+        CHECK_EQUAL("ПРИВЕТМИРЫ", product.decrypt(encrypted));
+    }
+
+    TEST(LargeRoundTrip) {
+        std::string text;
+        for (int i = 0; i < 5000; i++)
+            text += "Съешь же ещё этих мягких булок! ";
+        modAlphaCipher cipher("ПАРОЛЬ");
+        for (int key : {2, 7, 1000, 9000}) {
+            productCipher product("ПАРОЛЬ", key);
+            CHECK_EQUAL(cipher.decrypt(cipher.encrypt(text)), product.decrypt(product.encrypt(text)));
+        }
+    }
+
+    TEST(Errors) {
+        CHECK_THROW(productCipher("КЛЮЧ", 1), cipher_error);
+        CHECK_THROW(productCipher("ААА", 3), cipher_error);
+        productCipher product("КЛЮЧ", 3);
+        char out[8];
+        CHECK(product.encrypt_into("123", out, sizeof out).status == cipher_status::no_text);
+        CHECK(product.encrypt_into("ПРИВЕТМИР", out, sizeof out).status == cipher_status::small_buffer);
+        CHECK(product.encrypt_into("\xD0", out, sizeof out).status == cipher_status::bad_encoding);
+        CHECK(product.decrypt_into("", out, sizeof out).status == cipher_status::empty_text);
+        CHECK(product.decrypt_into("АБ В", out, sizeof out).status == cipher_status::invalid_text);
+        CHECK_THROW(product.decrypt("ЖЮЫЬПАЪЩк"), cipher_error);
+    }
+}
+
+/**
+ * @brief Записывает текст во временный файл
+ */
+static void writeFile(const char* path, const std::string& text)
+{
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+/**
+ * @brief Читает файл целиком
+ */
+static std::string readFile(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+SUITE(FileTest)
+{
+    TEST(MatchesInMemory) {
+        modAlphaCipher cipher("КЛЮЧ");
+        std::string text;
+        for (int i = 0; i < 20000; i++)
+            text += "Съешь же ещё этих мягких французских булок, да выпей чаю! ";
+        for (bool huge : {false, true}) {
+            writeFile("gronsfeld_in.tmp", text);
+            cipher.encrypt_file("gronsfeld_in.tmp", "gronsfeld_out.tmp", huge);
+            std::string encrypted = readFile("gronsfeld_out.tmp");
+            CHECK(encrypted == cipher.encrypt(text));
+            cipher.decrypt_file("gronsfeld_out.tmp", "gronsfeld_back.tmp", huge);
+            CHECK(readFile("gronsfeld_back.tmp") == cipher.decrypt(encrypted));
+        }
+        std::remove("gronsfeld_in.tmp");
+        std::remove("gronsfeld_out.tmp");
+        std::remove("gronsfeld_back.tmp");
+    }
+
+    TEST(Errors) {
+        modAlphaCipher cipher("КЛЮЧ");
+        CHECK_THROW(cipher.encrypt_file("gronsfeld_missing.tmp", "gronsfeld_out.tmp", false), std::system_error);
+        writeFile("gronsfeld_in.tmp", "");
+        CHECK_THROW(cipher.encrypt_file("gronsfeld_in.tmp", "gronsfeld_out.tmp", false), cipher_error);
+        CHECK_THROW(cipher.decrypt_file("gronsfeld_in.tmp", "gronsfeld_out.tmp", false), cipher_error);
+        writeFile("gronsfeld_in.tmp", "ПРИВЕТ МИР");
+        CHECK_THROW(cipher.decrypt_file("gronsfeld_in.tmp", "gronsfeld_out.tmp", false), cipher_error);
+        CHECK(!std::ifstream("gronsfeld_out.tmp"));
+        std::remove("gronsfeld_in.tmp");
+    }
+}
+
+SUITE(StatsTest)
+{
+    TEST(StagesCounted) {
+        modAlphaCipher cipher("КЛЮЧ");
+        cipherStats::snapshot before = cipherStats::take();
+        std::string encrypted = cipher.encrypt("Привет, мир!");
+        cipher.decrypt(encrypted);
+        cipherStats::snapshot d = cipherStats::difference(cipherStats::take(), before);
+#ifdef CIPHER_STATS
+        CHECK(d.enabled);
+        CHECK_EQUAL(uint64_t(21 + 18), d.stages[cipherStats::decode].bytes);
+        CHECK_EQUAL(uint64_t(9 + 9), d.stages[cipherStats::transform].bytes);
+        CHECK_EQUAL(uint64_t(18 + 18), d.stages[cipherStats::encode].bytes);
+        CHECK_EQUAL(uint64_t(2), d.allocations);
+#else
+        CHECK(!d.enabled);
+        CHECK_EQUAL(uint64_t(0), d.stages[cipherStats::transform].bytes);
+        CHECK_EQUAL(uint64_t(0), d.allocations);
+#endif
+    }
+}
+
+/**
+ * @brief Текст в 1 МБ, уже прошедший проверку: только прописные русские буквы
+ */
+static std::string validMegabyte() {
+    std::string text;
+    while (text.size() < (1u << 20))
+        text += "СЪЕШЬЖЕЕЩЁЭТИХМЯГКИХБУЛОК";
+    text.resize(1u << 20);
+    return text;
+}
+
+/// Бюджеты выделений памяти в установившемся режиме (второй и последующие вызовы)
+SUITE(AllocationBudgetTest)
+{
+    TEST_FIXTURE(allocationFixture, EncryptDecryptOneResult) {
+        modAlphaCipher cipher("КЛЮЧ");
+        std::string text = validMegabyte();
+        std::string encrypted = cipher.encrypt(text);
+        allocations.restart();
+        encrypted = cipher.encrypt(text);
+        CHECK(allocations.allocations() <= 1);
+        CHECK(allocations.bytes() <= text.size() + 1);
+        allocations.restart();
+        std::string decrypted = cipher.decrypt(encrypted);
+        CHECK(allocations.allocations() <= 1);
+        CHECK(allocations.bytes() <= encrypted.size() + 1);
+    }
+
+    TEST_FIXTURE(allocationFixture, IntoAndBatchNone) {
+        modAlphaCipher cipher("КЛЮЧ");
+        std::string text = validMegabyte();
+        std::string out(text.size(), '\0');
+        std::vector<std::string_view> texts(16, std::string_view(text).substr(0, 65536));
+        cipher_batch batch;
+        cipher.encrypt_batch(texts.data(), texts.size(), batch);
+        allocations.restart();
+        cipher_result e = cipher.encrypt_into(text, &out[0], out.size());
+        cipher.decrypt_into(std::string_view(out.data(), e.size), &out[0], out.size());
+        cipher.encrypt_batch(texts.data(), texts.size(), batch);
+        cipher.decrypt_batch(texts.data(), texts.size(), batch);
+        CHECK_EQUAL(size_t(0), allocations.allocations());
+    }
+
+    TEST_FIXTURE(allocationFixture, StreamOneChunk) {
+        modAlphaCipher cipher("КЛЮЧ");
+        modAlphaStream stream(cipher, modAlphaStream::encryption);
+        std::string chunk = validMegabyte().substr(0, 65536);
+        stream.update(chunk);
+        allocations.restart();
+        stream.update(chunk);
+        CHECK(allocations.allocations() <= 1);
+    }
+
+    TEST_FIXTURE(allocationFixture, ParallelPerThread) {
+        modAlphaCipher cipher("КЛЮЧ");
+        std::string text = validMegabyte();
+        std::string encrypted = cipher.encrypt(text, 4);
+        allocations.restart();
+        encrypted = cipher.encrypt(text, 4);
+        // Результат, границы частей и служебные данные потоков
+        CHECK(allocations.allocations() <= 6 + 4 * 4);
+        CHECK(allocations.bytes() <= text.size() + 4096);
+    }
+
+    TEST_FIXTURE(allocationFixture, ProductCipher) {
+        productCipher cipher("КЛЮЧ", 7);
+        std::string text = validMegabyte();
+        std::string out(text.size(), '\0');
+        std::string encrypted = cipher.encrypt(text);
+        allocations.restart();
+        encrypted = cipher.encrypt(text);
+        CHECK(allocations.allocations() <= 1);
+        allocations.restart();
+        cipher.decrypt(encrypted);
+        CHECK(allocations.allocations() <= 1);
+        allocations.restart();
+        cipher_result e = cipher.encrypt_into(text, &out[0], out.size());
+        cipher.decrypt_into(std::string_view(out.data(), e.size), &out[0], out.size());
+        CHECK_EQUAL(size_t(0), allocations.allocations());
+    }
+
+    TEST_FIXTURE(allocationFixture, StaticCipher) {
+        std::string text = validMegabyte();
+        std::string encrypted = staticAlphaCipher<keyKlyuch>::encrypt(std::string_view(text));
+        allocations.restart();
+        encrypted = staticAlphaCipher<keyKlyuch>::encrypt(std::string_view(text));
+        CHECK(allocations.allocations() <= 1);
+        allocations.restart();
+        staticAlphaCipher<keyKlyuch>::decrypt(encrypted);
+        CHECK(allocations.allocations() <= 1);
+    }
+}
+
 /**
  * @brief Главная функция запуска тестов
  * @param argc Количество аргументов
@@ -7,11 +7,16 @@
  */
 
 #include "modAlphaCipher.h"
-#include <locale>
-#include <codecvt>
+#include "../../cipherlib/mappedFile.h"
+#include "../../cipherlib/shiftKernel.h"
+#include <algorithm>
+#include <cstdio>
+#include <exception>
 #include <iostream>
+#include <system_error>
+#include <thread>
 
-std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> codec; ///< Конвертер UTF-8 <-> wstring
+static const size_t blockSize = 4096; ///< Число букв, сдвигаемых ядром за один вызов
 
 /**
  * @brief Конструктор класса modAlphaCipher
@@ -19,9 +24,7 @@ std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> codec; ///< Конве
  * @throw cipher_error При недопустимом ключе
  */
 modAlphaCipher::modAlphaCipher(const std::string& skey) {
-    for (unsigned i = 0; i < numAlpha.size(); i++)
-        alphaNum[numAlpha[i]] = i;
-    key = convert(getValidKey(skey));
+    key = getValidKey(skey);
     
     if (key.size() > 1) {
         bool allSame = true;
@@ -34,6 +37,30 @@ modAlphaCipher::modAlphaCipher(const std::string& skey) {
         if (allSame)
             throw cipher_error("WeakKey");
     }
+    encStream = makeKeyStream(key, false);
+    decStream = makeKeyStream(key, true);
+}
+
+/**
+ * @brief Выбрасывает cipher_error, соответствующий коду результата
+ * @param status Код результата
+ * @throw cipher_error Если status отличен от cipher_status::ok
+ */
+static void check(cipher_status status) {
+    switch (status) {
+    case cipher_status::ok:
+        return;
+    case cipher_status::no_text:
+        throw cipher_error("Отсутствует открытый текст!");
+    case cipher_status::empty_text:
+        throw cipher_error("Empty cipher text");
+    case cipher_status::invalid_text:
+        throw cipher_error("Неправильный зашифрованный текст!");
+    case cipher_status::bad_encoding:
+        throw cipher_error("Некорректная кодировка UTF-8");
+    case cipher_status::small_buffer:
+        throw cipher_error("Недостаточный размер буфера");
+    }
 }
 
 /**
@@ -41,11 +68,13 @@ modAlphaCipher::modAlphaCipher(const std::string& skey) {
  * @param open_text Открытый текст
  * @return Зашифрованная строка
  */
-std::string modAlphaCipher::encrypt(const std::string& open_text) {
-    std::vector<int> work = convert(getValidOpenText(open_text));
-    for (unsigned i = 0; i < work.size(); i++)
-        work[i] = (work[i] + key[i % key.size()]) % alphaNum.size();
-    return convert(work);
+std::string modAlphaCipher::encrypt(const std::string& open_text) const {
+    std::string result(open_text.size(), '\0');
+    cipherStats::allocation(result.size());
+    cipher_result r = encrypt_into(open_text, &result[0], result.size());
+    check(r.status);
+    result.resize(r.size);
+    return result;
 }
 
 /**
@@ -53,105 +82,415 @@ std::string modAlphaCipher::encrypt(const std::string& open_text) {
  * @param cipher_text Зашифрованный текст
  * @return Расшифрованная строка
  */
-std::string modAlphaCipher::decrypt(const std::string& cipher_text) {
-    std::vector<int> work = convert(getValidCipherText(cipher_text));
-    for (unsigned i = 0; i < work.size(); i++)
-        work[i] = (work[i] + alphaNum.size() - key[i % key.size()]) % alphaNum.size();
-    return convert(work);
+std::string modAlphaCipher::decrypt(const std::string& cipher_text) const {
+    std::string result(cipher_text.size(), '\0');
+    cipherStats::allocation(result.size());
+    check(decrypt_into(cipher_text, &result[0], result.size()).status);
+    return result;
+}
+
+cipher_result modAlphaCipher::encrypt_into(std::string_view open_text, char* out, size_t out_size) const noexcept {
+    size_t written = 0;
+    size_t pos = 0;
+    cipher_status status = encryptBytes(open_text.data(), open_text.size(), out, out_size, written, pos);
+    if (status == cipher_status::ok && written == 0)
+        status = cipher_status::no_text;
+    return {status == cipher_status::ok ? written : 0, status};
+}
+
+cipher_result modAlphaCipher::decrypt_into(std::string_view cipher_text, char* out, size_t out_size) const noexcept {
+    if (cipher_text.empty())
+        return {0, cipher_status::empty_text};
+    size_t pos = 0;
+    cipher_status status = decryptBytes(cipher_text.data(), cipher_text.size(), out, out_size, pos);
+    return {status == cipher_status::ok ? cipher_text.size() : 0, status};
 }
 
 /**
- * @brief Преобразует строку в вектор числовых кодов
- * @param s Входная строка
- * @return Вектор номеров символов в алфавите
+ * @brief Обрабатывает пакет сообщений одной функцией записи в буфер
+ * @details Результат не длиннее входа, поэтому буфер выделяется один раз
+ *          по суммарному размеру входов.
+ * @param texts Входные тексты
+ * @param count Количество сообщений
+ * @param out Результаты
+ * @param into Функция вида encrypt_into/decrypt_into
  */
-std::vector<int> modAlphaCipher::convert(const std::string& s) {
-    std::wstring ws = codec.from_bytes(s);
-    std::vector<int> result;
-    for (auto c : ws)
-        result.push_back(alphaNum[c]);
-    return result;
+template <class F>
+static void runBatch(const std::string_view* texts, size_t count, cipher_batch& out, F into) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += texts[i].size();
+    if (total > out.arena.capacity())
+        cipherStats::allocation(total);
+    out.arena.resize(total);
+    out.offsets.resize(count + 1);
+    out.status.resize(count);
+    size_t used = 0;
+    out.offsets[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        cipher_result r = into(texts[i], &out.arena[used], total - used);
+        out.status[i] = r.status;
+        used += r.size;
+        out.offsets[i + 1] = used;
+    }
+    out.arena.resize(used);
+}
+
+void modAlphaCipher::encrypt_batch(const std::string_view* texts, size_t count, cipher_batch& out) const {
+    runBatch(texts, count, out, [this](std::string_view s, char* p, size_t n) { return encrypt_into(s, p, n); });
+}
+
+void modAlphaCipher::decrypt_batch(const std::string_view* texts, size_t count, cipher_batch& out) const {
+    runBatch(texts, count, out, [this](std::string_view s, char* p, size_t n) { return decrypt_into(s, p, n); });
+}
+
+/**
+ * @brief Обрабатывает файл функцией записи в буфер по отображениям в память
+ * @param input Путь к входному файлу
+ * @param output Путь к выходному файлу
+ * @param hugePages Просить большие страницы
+ * @param into Функция вида encrypt_into/decrypt_into
+ */
+template <class F>
+static void runFile(const std::string& input, const std::string& output, bool hugePages, F into) {
+    mappedFile in = mappedFile::openRead(input, hugePages);
+    mappedFile out = mappedFile::create(output, in.size(), hugePages);
+    cipher_result r = into(std::string_view(in.data(), in.size()), out.data(), out.size());
+    if (r.status != cipher_status::ok) {
+        out.close();
+        std::remove(output.c_str());
+        check(r.status);
+    }
+    out.resize(r.size);
+    out.close();
+}
+
+void modAlphaCipher::encrypt_file(const std::string& input, const std::string& output, bool hugePages) const {
+    runFile(input, output, hugePages, [this](std::string_view s, char* p, size_t n) { return encrypt_into(s, p, n); });
+}
+
+void modAlphaCipher::decrypt_file(const std::string& input, const std::string& output, bool hugePages) const {
+    runFile(input, output, hugePages, [this](std::string_view s, char* p, size_t n) { return decrypt_into(s, p, n); });
+}
+
+/**
+ * @brief Выполняет f(0..parts-1) параллельно, часть 0 - в вызывающем потоке
+ * @param parts Количество частей
+ * @param f Функция обработки части
+ * @throw Первое исключение, выброшенное любой из частей
+ */
+template <class F>
+static void parallelFor(size_t parts, F f) {
+    std::vector<std::exception_ptr> errors(parts);
+    std::vector<std::thread> workers;
+    auto guarded = [&](size_t t) {
+        try {
+            f(t);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    workers.reserve(parts);
+    size_t started = 1;
+    try {
+        for (; started < parts; started++)
+            workers.emplace_back(guarded, started);
+    } catch (const std::system_error&) {
+        // Поток не запустился: оставшиеся части выполняются в вызывающем потоке
+    }
+    guarded(0);
+    for (size_t t = started; t < parts; t++)
+        guarded(t);
+    for (auto& w : workers)
+        w.join();
+    for (auto& e : errors)
+        if (e)
+            std::rethrow_exception(e);
 }
 
 /**
- * @brief Преобразует вектор числовых кодов в строку
- * @param v Вектор номеров символов
- * @return Строка, соответствующая вектору
+ * @brief Делит текст на части, начинающиеся на границах символов
+ * @param s Текст
+ * @param threads Запрошенное количество потоков (0 - по числу ядер)
+ * @param align Кратность границ в байтах (2 для зашифрованного текста)
+ * @return Границы частей: первая 0, последняя s.size()
  */
-std::string modAlphaCipher::convert(const std::vector<int>& v) {
-    std::wstring ws;
-    for (auto i : v)
-        ws.push_back(numAlpha[i]);
-    std::string result = codec.to_bytes(ws);
+static std::vector<size_t> splitText(const std::string& s, unsigned threads, size_t align) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t parts = std::max<size_t>(1, std::min<size_t>(threads, s.size() / modAlphaCipher::minParallelBytes));
+    std::vector<size_t> bounds(1, 0);
+    for (size_t t = 1; t < parts; t++) {
+        size_t b = s.size() / parts * t / align * align;
+        while (align == 1 && b < s.size() && (static_cast<unsigned char>(s[b]) & 0xC0) == 0x80)
+            b++;
+        if (b > bounds.back())
+            bounds.push_back(b);
+    }
+    bounds.push_back(s.size());
+    return bounds;
+}
+
+/**
+ * @brief Подсчитывает русские буквы (А..я) в UTF-8 тексте без полной проверки
+ * @param in Текст
+ * @param n Размер в байтах
+ * @return Количество букв, которые зашифрует encryptBytes
+ */
+static size_t countLetters(const char* in, size_t n) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    size_t count = 0;
+    for (size_t i = 0; i + 1 < n; i++)
+        count += (src[i] == 0xD0 && src[i + 1] >= 0x90) || (src[i] == 0xD1 && src[i + 1] >= 0x80 && src[i + 1] < 0x90);
+    return count;
+}
+
+std::string modAlphaCipher::encrypt(const std::string& open_text, unsigned threads) const {
+    std::vector<size_t> bounds = splitText(open_text, threads, 1);
+    size_t parts = bounds.size() - 1;
+    if (parts == 1)
+        return encrypt(open_text);
+    std::vector<size_t> letters(parts + 1, 0);
+    parallelFor(parts, [&](size_t t) {
+        cipherStats::stageClock clock;
+        letters[t + 1] = countLetters(open_text.data() + bounds[t], bounds[t + 1] - bounds[t]);
+        clock.charge(cipherStats::validate, bounds[t + 1] - bounds[t]);
+    });
+    for (size_t t = 0; t < parts; t++)
+        letters[t + 1] += letters[t];
+    if (letters[parts] == 0)
+        check(cipher_status::no_text);
+    std::string result(2 * letters[parts], '\0');
+    cipherStats::allocation(result.size());
+    parallelFor(parts, [&](size_t t) {
+        size_t pos = letters[t] % key.size();
+        size_t size = 2 * (letters[t + 1] - letters[t]);
+        size_t written = 0;
+        check(encryptBytes(open_text.data() + bounds[t], bounds[t + 1] - bounds[t], &result[2 * letters[t]], size,
+                           written, pos));
+        if (written != size)
+            check(cipher_status::bad_encoding);
+    });
+    return result;
+}
+
+std::string modAlphaCipher::decrypt(const std::string& cipher_text, unsigned threads) const {
+    std::vector<size_t> bounds = splitText(cipher_text, threads, 2);
+    size_t parts = bounds.size() - 1;
+    if (parts == 1)
+        return decrypt(cipher_text);
+    if (cipher_text.size() % 2)
+        check(cipher_status::invalid_text);
+    std::string result(cipher_text.size(), '\0');
+    cipherStats::allocation(result.size());
+    parallelFor(parts, [&](size_t t) {
+        size_t pos = bounds[t] / 2 % key.size();
+        size_t size = bounds[t + 1] - bounds[t];
+        check(decryptBytes(cipher_text.data() + bounds[t], size, &result[bounds[t]], size, pos));
+    });
     return result;
 }
 
 /**
- * @brief Проверяет и нормализует ключ
- * @param s Исходный ключ
- * @return Ключ в верхнем регистре без не-букв
- * @throw cipher_error Если ключ пустой или содержит не-буквы
+ * @brief Определяет длину UTF-8 последовательности и проверяет её целостность
+ * @param in Входные байты
+ * @param i Позиция начала последовательности
+ * @param n Размер входа
+ * @return Длина последовательности в байтах или 0, если она некорректна или обрезана
  */
-std::string modAlphaCipher::getValidKey(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
-    if (ws.empty())
-        throw cipher_error("Пустой ключ");
-    
-    std::wstring tmp = ws;
-    for (auto& c : tmp) {
-        if (c < L'А' || c > L'я')
-            throw cipher_error("Неверный ключ: содержит не-буквенные символы");
-        if (c >= L'а' && c <= L'я')
-            c -= 32;
+static inline size_t utf8Length(const unsigned char* in, size_t i, size_t n) {
+    unsigned char b = in[i];
+    size_t len = b < 0x80 ? 1 : b < 0xC2 ? 0 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF5 ? 4 : 0;
+    if (i + len > n)
+        return 0;
+    for (size_t j = 1; j < len; j++)
+        if ((in[i + j] & 0xC0) != 0x80)
+            return 0;
+    return len;
+}
+
+/**
+ * @brief Сдвигает накопленный блок номеров букв ядром и кодирует его в UTF-8
+ * @param block Номера букв
+ * @param count Количество номеров в блоке
+ * @param out Буфер результата (2 * count байт)
+ * @param pos Позиция в ключе, обновляется
+ * @param stream Поток ключа для шифрования или расшифрования
+ * @param clock Секундомер этапов: сдвиг относится к transform, запись - к encode
+ * @return Количество записанных байт
+ */
+size_t modAlphaCipher::flushBlock(unsigned char* block, size_t count, char* out, size_t& pos,
+                                  const std::vector<unsigned char>& stream, cipherStats::stageClock& clock) const {
+    shiftAdd(block, count, stream.data(), key.size(), pos);
+    pos = (pos + count) % key.size();
+    clock.charge(cipherStats::transform, count);
+    for (size_t i = 0; i < count; i++) {
+        out[2 * i] = alpha.utf8[block[i]][0];
+        out[2 * i + 1] = alpha.utf8[block[i]][1];
     }
-    
-    std::string mp = codec.to_bytes(tmp);
-    return mp;
+    clock.charge(cipherStats::encode, 2 * count);
+    return 2 * count;
+}
+
+cipher_status modAlphaCipher::encryptBytes(const char* in, size_t n, char* out, size_t out_size, size_t& written,
+                                           size_t& pos) const {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    unsigned char block[blockSize];
+    size_t count = 0;
+    written = 0;
+    cipherStats::stageClock clock;
+    size_t decoded = 0; // Начало ещё не учтённой части входа
+    for (size_t i = 0; i < n;) {
+        size_t len = utf8Length(src, i, n);
+        if (len == 0)
+            return cipher_status::bad_encoding;
+        if (len == 2) {
+            wchar_t c = ((src[i] & 0x1F) << 6) | (src[i + 1] & 0x3F);
+            if (c >= L'А' && c <= L'я') {
+                block[count++] = alpha.index(c >= L'а' ? c - 32 : c);
+                if (count == blockSize) {
+                    if (written + 2 * count > out_size)
+                        return cipher_status::small_buffer;
+                    clock.charge(cipherStats::decode, i + len - decoded);
+                    decoded = i + len;
+                    written += flushBlock(block, count, out + written, pos, encStream, clock);
+                    count = 0;
+                }
+            }
+        }
+        i += len;
+    }
+    if (written + 2 * count > out_size)
+        return cipher_status::small_buffer;
+    clock.charge(cipherStats::decode, n - decoded);
+    written += flushBlock(block, count, out + written, pos, encStream, clock);
+    return cipher_status::ok;
+}
+
+cipher_status modAlphaCipher::decryptBytes(const char* in, size_t n, char* out, size_t out_size, size_t& pos) const {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(in);
+    unsigned char block[blockSize];
+    if (n % 2)
+        return cipher_status::invalid_text;
+    if (n > out_size)
+        return cipher_status::small_buffer;
+    cipherStats::stageClock clock;
+    for (size_t i = 0; i < n;) {
+        size_t count = std::min(blockSize, (n - i) / 2);
+        for (size_t j = 0; j < count; j++, i += 2) {
+            int v = -1;
+            if (src[i] == 0xD0 && (src[i + 1] & 0xC0) == 0x80)
+                v = alpha.index(0x400 | (src[i + 1] & 0x3F));
+            if (v < 0)
+                return cipher_status::invalid_text;
+            block[j] = static_cast<unsigned char>(v);
+        }
+        clock.charge(cipherStats::decode, 2 * count);
+        flushBlock(block, count, out + i - 2 * count, pos, decStream, clock);
+    }
+    return cipher_status::ok;
 }
 
 /**
- * @brief Проверяет и нормализует открытый текст
- * @param s Исходный открытый текст
- * @return Текст в верхнем регистре без не-букв
- * @throw cipher_error Если текст пустой после удаления не-букв
+ * @brief Возвращает длину UTF-8 последовательности по первому байту
+ * @param b Первый байт
+ * @return Ожидаемая длина; 1 для ASCII и некорректных байт
  */
-std::string modAlphaCipher::getValidOpenText(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
-    std::wstring tmp;
-    
-    for (auto c : ws) {
-        if (c >= L'А' && c <= L'я') {
-            if (c >= L'а' && c <= L'я')
-                tmp.push_back(c - 32);
-            else
-                tmp.push_back(c);
+static inline size_t utf8LeadLength(unsigned char b) {
+    return b < 0xC0 ? 1 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : 4;
+}
+
+/**
+ * @brief Находит конец последней полной UTF-8 последовательности
+ * @param s Текст
+ * @param start Начало рассматриваемой части
+ * @return Позиция, с которой начинается незавершённая последовательность (или s.size())
+ */
+static size_t completeEnd(const std::string& s, size_t start) {
+    size_t end = s.size();
+    for (size_t i = end; i > start && end - i < 4;) {
+        unsigned char b = s[--i];
+        if ((b & 0xC0) != 0x80)
+            return i + utf8LeadLength(b) > end ? i : end;
+    }
+    return end;
+}
+
+modAlphaStream::modAlphaStream(const modAlphaCipher& cipher, mode m): cipher(cipher), dir(m) {}
+
+/**
+ * @brief Преобразует полные последовательности и отмечает появление букв
+ * @param in Вход
+ * @param n Размер входа
+ * @param out Буфер результата размером не меньше n
+ * @return Количество записанных байт
+ * @throw cipher_error Если вход содержит недопустимые символы
+ */
+size_t modAlphaStream::run(const char* in, size_t n, char* out) {
+    size_t written = n;
+    check(dir == encryption ? cipher.encryptBytes(in, n, out, n, written, pos) : cipher.decryptBytes(in, n, out, n, pos));
+    if (written)
+        empty = false;
+    return written;
+}
+
+std::string modAlphaStream::update(const std::string& chunk) {
+    std::string result(pending.size() + chunk.size(), '\0');
+    cipherStats::allocation(result.size());
+    size_t written = 0;
+    size_t start = 0;
+    if (!pending.empty()) {
+        size_t need = utf8LeadLength(pending[0]) - pending.size();
+        start = std::min(need, chunk.size());
+        pending.append(chunk, 0, start);
+        if (start < need) {
+            result.clear();
+            return result;
         }
+        written = run(pending.data(), pending.size(), &result[0]);
+        pending.clear();
     }
-    
-    if (tmp.empty())
-        throw cipher_error("Отсутствует открытый текст!");
-    
-    std::string mp = codec.to_bytes(tmp);
-    return mp;
+    size_t end = completeEnd(chunk, start);
+    written += run(chunk.data() + start, end - start, &result[written]);
+    pending.assign(chunk, end, std::string::npos);
+    result.resize(written);
+    return result;
+}
+
+std::string modAlphaStream::finish() {
+    bool truncated = !pending.empty();
+    bool noText = empty;
+    pos = 0;
+    empty = true;
+    pending.clear();
+    if (truncated)
+        check(cipher_status::bad_encoding);
+    if (noText)
+        check(dir == encryption ? cipher_status::no_text : cipher_status::empty_text);
+    return std::string();
 }
 
 /**
- * @brief Проверяет зашифрованный текст
- * @param s Зашифрованный текст
- * @return Текст без изменений
- * @throw cipher_error Если текст пустой или содержит недопустимые символы
+ * @brief Проверяет ключ и переводит его в числовой вид
+ * @param s Исходный ключ в UTF-8
+ * @return Номера букв ключа (строчные буквы приводятся к прописным)
+ * @throw cipher_error Если ключ пустой, содержит не-буквы или некорректный UTF-8
  */
-std::string modAlphaCipher::getValidCipherText(const std::string & s) {
-    std::wstring ws = codec.from_bytes(s);
-    
-    if (ws.empty())
-        throw cipher_error("Empty cipher text");
-    
-    for (auto c : ws) {
-        if ((c < L'А' || c > L'Я') && c != L'Ё')
-            throw cipher_error("Неправильный зашифрованный текст!");
+std::vector<int> modAlphaCipher::getValidKey(const std::string & s) {
+    if (s.empty())
+        throw cipher_error("Пустой ключ");
+
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(s.data());
+    std::vector<int> result;
+    for (size_t i = 0; i < s.size();) {
+        size_t len = utf8Length(src, i, s.size());
+        if (len == 0)
+            check(cipher_status::bad_encoding);
+        wchar_t c = len == 2 ? ((src[i] & 0x1F) << 6) | (src[i + 1] & 0x3F) : 0;
+        if (c < L'А' || c > L'я')
+            throw cipher_error("Неверный ключ: содержит не-буквенные символы");
+        result.push_back(alpha.index(c >= L'а' ? c - 32 : c));
+        i += len;
     }
-    
-    std::string mp = codec.to_bytes(ws);
-    return mp;
+    return result;
 }
\ No newline at end of file
@@ -8,12 +8,12 @@
  */
 
 #pragma once
+#include "../../cipherlib/alphaTable.h"
+#include "../../cipherlib/cipherStats.h"
 #include <vector>
 #include <string>
-#include <map>
+#include <string_view>
 #include <stdexcept>
-#include <locale>
-#include <codecvt>
 
 /**
  * @class cipher_error
@@ -28,25 +28,102 @@ public:
         std::invalid_argument(what_arg) {}
 };
 
+/**
+ * @enum cipher_status
+ * @brief Код результата операций, не выбрасывающих исключений
+ */
+enum class cipher_status {
+    ok,           ///< Успешно
+    no_text,      ///< В открытом тексте нет букв
+    empty_text,   ///< Пустой зашифрованный текст
+    invalid_text, ///< Зашифрованный текст содержит символы вне алфавита
+    bad_encoding, ///< Некорректная кодировка UTF-8
+    small_buffer  ///< Буфер результата слишком мал
+};
+
+/**
+ * @struct cipher_result
+ * @brief Результат записи в буфер вызывающей стороны
+ */
+struct cipher_result {
+    size_t size; ///< Количество записанных байт (0 при ошибке)
+    cipher_status status; ///< Код результата
+};
+
+/**
+ * @struct cipher_batch
+ * @brief Результаты пакетной обработки в одном непрерывном буфере
+ * @details Результат i-го сообщения занимает arena[offsets[i], offsets[i + 1]).
+ *          При повторном использовании объекта буферы не перевыделяются, если
+ *          их ёмкости достаточно.
+ */
+struct cipher_batch {
+    std::string arena; ///< Результаты всех сообщений подряд
+    std::vector<size_t> offsets; ///< Границы результатов (count + 1 значение)
+    std::vector<cipher_status> status; ///< Код результата каждого сообщения
+
+    /// Количество сообщений в пакете
+    size_t size() const {
+        return status.size();
+    }
+
+    /// Результат i-го сообщения (пустой при ошибке)
+    std::string_view operator[](size_t i) const {
+        return std::string_view(arena).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
 /**
  * @class modAlphaCipher
  * @brief Класс для шифрования и расшифрования текста методом Гронсфельда (русский алфавит)
  * @details Использует русский алфавит из 33 букв (А-Я, Ё). 
  *          Ключ и текст должны содержать только русские буквы (регистр не важен).
+ *          После конструирования объект не изменяется: все методы константны и не
+ *          используют общего изменяемого состояния, поэтому один объект можно
+ *          одновременно вызывать из нескольких потоков.
  */
 class modAlphaCipher {
+    friend class modAlphaStream;
+    friend class productCipher;
 private:
-    std::wstring numAlpha = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"; ///< Алфавит по порядку
-    std::map<wchar_t,int> alphaNum; ///< Ассоциативный массив "символ -> номер"
     std::vector<int> key; ///< Ключ в числовом виде
+    std::vector<unsigned char> encStream; ///< Поток ключа для ядра сдвига при шифровании
+    std::vector<unsigned char> decStream; ///< Поток ключа для ядра сдвига при расшифровании
 
-    std::vector<int> convert(const std::string& s);
-    std::string convert(const std::vector<int>& v);
-    std::string getValidKey(const std::string & s);
-    std::string getValidOpenText(const std::string & s);
-    std::string getValidCipherText(const std::string & s);
+    static std::vector<int> getValidKey(const std::string & s);
+    size_t flushBlock(unsigned char* block, size_t count, char* out, size_t& pos,
+                      const std::vector<unsigned char>& stream, cipherStats::stageClock& clock) const;
+
+    /**
+     * @brief Шифрует UTF-8 текст за один проход без промежуточных wstring
+     * @details Не-буквы пропускаются, строчные буквы приводятся к прописным.
+     *          Размер результата не превышает размер входа.
+     * @param in Входной текст в UTF-8
+     * @param n Размер входа в байтах
+     * @param out Буфер результата
+     * @param out_size Размер буфера результата
+     * @param written Количество записанных байт
+     * @param pos Позиция в ключе, продолжается с переданного значения
+     * @return Код результата; при ошибке содержимое out не определено
+     */
+    cipher_status encryptBytes(const char* in, size_t n, char* out, size_t out_size, size_t& written,
+                               size_t& pos) const;
+
+    /**
+     * @brief Расшифровывает UTF-8 текст за один проход без промежуточных wstring
+     * @details Размер результата всегда равен размеру входа.
+     * @param in Зашифрованный текст в UTF-8
+     * @param n Размер входа в байтах
+     * @param out Буфер результата
+     * @param out_size Размер буфера результата
+     * @param pos Позиция в ключе, продолжается с переданного значения
+     * @return Код результата; при ошибке содержимое out не определено
+     */
+    cipher_status decryptBytes(const char* in, size_t n, char* out, size_t out_size, size_t& pos) const;
 
 public:
+    static constexpr alphaTable alpha{}; ///< Таблицы алфавита (общие для всех экземпляров)
+
     modAlphaCipher() = delete; ///< Запрет конструктора без параметров
 
     /**
@@ -62,7 +139,7 @@ public:
      * @return Зашифрованная строка (в верхнем регистре)
      * @throw cipher_error Если текст пустой или не содержит букв
      */
-    std::string encrypt(const std::string& open_text);
+    std::string encrypt(const std::string& open_text) const;
 
     /**
      * @brief Расшифровывает зашифрованный текст
@@ -70,5 +147,146 @@ public:
      * @return Расшифрованная строка (в верхнем регистре)
      * @throw cipher_error Если текст пустой или содержит недопустимые символы
      */
-    std::string decrypt(const std::string& cipher_text);
-};
\ No newline at end of file
+    std::string decrypt(const std::string& cipher_text) const;
+
+    /**
+     * @brief Шифрует открытый текст в несколько потоков
+     * @details Текст делится на части по границам UTF-8 символов; каждая часть
+     *          обрабатывается со своей позиции в ключе. Результат совпадает с encrypt().
+     *          Части меньше minParallelBytes не выделяются.
+     * @param open_text Текст для шифрования
+     * @param threads Количество потоков (0 - по числу ядер)
+     * @return Зашифрованная строка (в верхнем регистре)
+     * @throw cipher_error Если текст пустой или не содержит букв
+     */
+    std::string encrypt(const std::string& open_text, unsigned threads) const;
+
+    /**
+     * @brief Расшифровывает текст в несколько потоков
+     * @details Результат совпадает с decrypt().
+     * @param cipher_text Зашифрованный текст
+     * @param threads Количество потоков (0 - по числу ядер)
+     * @return Расшифрованная строка (в верхнем регистре)
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    std::string decrypt(const std::string& cipher_text, unsigned threads) const;
+
+    /**
+     * @brief Шифрует текст в буфер вызывающей стороны без выделения памяти
+     * @details Результат никогда не длиннее входа, поэтому буфера размером
+     *          open_text.size() всегда достаточно. Исключения не выбрасываются.
+     * @param open_text Текст для шифрования
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result encrypt_into(std::string_view open_text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Расшифровывает текст в буфер вызывающей стороны без выделения памяти
+     * @details Результат всегда той же длины, что и вход. Исключения не выбрасываются.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result decrypt_into(std::string_view cipher_text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Шифрует пакет сообщений в общий буфер
+     * @details Ошибки отдельных сообщений не прерывают обработку и возвращаются
+     *          в out.status; исключения для них не выбрасываются.
+     * @param texts Открытые тексты
+     * @param count Количество сообщений
+     * @param out Результаты; прежнее содержимое заменяется
+     * @throw std::bad_alloc Если не удалось выделить память под результаты
+     */
+    void encrypt_batch(const std::string_view* texts, size_t count, cipher_batch& out) const;
+
+    /**
+     * @brief Расшифровывает пакет сообщений в общий буфер
+     * @details Ошибки отдельных сообщений возвращаются в out.status.
+     * @param texts Зашифрованные тексты
+     * @param count Количество сообщений
+     * @param out Результаты; прежнее содержимое заменяется
+     * @throw std::bad_alloc Если не удалось выделить память под результаты
+     */
+    void decrypt_batch(const std::string_view* texts, size_t count, cipher_batch& out) const;
+
+    /**
+     * @brief Шифрует файл через отображение в память
+     * @details Ядро работает прямо по отображениям входного и выходного файлов.
+     *          Выходной файл создаётся размером с входной и обрезается до длины
+     *          результата. Результат совпадает с encrypt() для содержимого файла.
+     * @param input Путь к открытому тексту в UTF-8
+     * @param output Путь к результату (удаляется при ошибке в тексте)
+     * @param hugePages Просить у ядра большие страницы для отображений
+     * @throw cipher_error Если текст не содержит букв или некорректен
+     * @throw std::system_error Если файлы не открываются или не отображаются
+     */
+    void encrypt_file(const std::string& input, const std::string& output, bool hugePages) const;
+
+    /**
+     * @brief Расшифровывает файл через отображение в память
+     * @details Длина UTF-8 сохраняется, поэтому выходной файл сразу создаётся
+     *          размером с входной. Результат совпадает с decrypt().
+     * @param input Путь к зашифрованному тексту
+     * @param output Путь к результату (удаляется при ошибке в тексте)
+     * @param hugePages Просить у ядра большие страницы для отображений
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     * @throw std::system_error Если файлы не открываются или не отображаются
+     */
+    void decrypt_file(const std::string& input, const std::string& output, bool hugePages) const;
+
+    static const size_t minParallelBytes = 64 * 1024; ///< Минимальный размер части для отдельного потока
+};
+
+/**
+ * @class modAlphaStream
+ * @brief Потоковое шифрование и расшифрование по частям
+ * @details Позиция в ключе и незавершённая UTF-8 последовательность переносятся
+ *          между вызовами update(), поэтому результат совпадает с однократным
+ *          вызовом modAlphaCipher::encrypt/decrypt для всего текста при любом
+ *          разбиении на части. Объём памяти не зависит от размера текста.
+ */
+class modAlphaStream {
+public:
+    /// Направление преобразования
+    enum mode {
+        encryption, ///< Шифрование
+        decryption  ///< Расшифрование
+    };
+
+    modAlphaStream() = delete; ///< Запрет конструктора без параметров
+
+    /**
+     * @brief Конструктор потока
+     * @param cipher Шифр с ключом; должен существовать, пока используется поток
+     * @param m Направление преобразования
+     */
+    modAlphaStream(const modAlphaCipher& cipher, mode m);
+
+    /**
+     * @brief Обрабатывает очередную часть текста
+     * @param chunk Часть текста в UTF-8, может обрываться посреди символа
+     * @return Результат для всех завершённых в этой части символов
+     * @throw cipher_error Если текст содержит недопустимые символы
+     */
+    std::string update(const std::string& chunk);
+
+    /**
+     * @brief Завершает поток и сбрасывает его состояние для повторного использования
+     * @return Остаток результата (пустая строка, так как символы не задерживаются)
+     * @throw cipher_error Если текст оборван посреди символа или не содержал букв
+     */
+    std::string finish();
+
+private:
+    const modAlphaCipher& cipher; ///< Шифр с ключом
+    mode dir; ///< Направление преобразования
+    size_t pos = 0; ///< Позиция в ключе
+    bool empty = true; ///< В поток ещё не поступило ни одной буквы
+    std::string pending; ///< Начало незавершённой UTF-8 последовательности
+
+    size_t run(const char* in, size_t n, char* out);
+};
@@ -0,0 +1,216 @@
+/**
+ * @file productCipher.cpp
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Реализация составного шифра productCipher
+ */
+
+#include "productCipher.h"
+#include "../../cipherlib/shiftKernel.h"
+#include <algorithm>
+#include <cstring>
+
+static const size_t blockSize = 4096; ///< Число букв, сдвигаемых ядром за один вызов
+
+/**
+ * @brief Конструктор класса productCipher
+ * @param skey Ключ шифра Гронсфельда
+ * @param routeKey Количество столбцов таблицы
+ * @throw cipher_error При недопустимом ключе
+ */
+productCipher::productCipher(const std::string& skey, int routeKey): subst(skey) {
+    if (routeKey < 2)
+        throw cipher_error("Ключ некорректного размера");
+    columns = routeKey;
+}
+
+/**
+ * @brief Выбрасывает cipher_error, соответствующий коду результата
+ * @param status Код результата
+ * @throw cipher_error Если status отличен от cipher_status::ok
+ */
+static void check(cipher_status status) {
+    switch (status) {
+    case cipher_status::ok:
+        return;
+    case cipher_status::no_text:
+        throw cipher_error("Отсутствует открытый текст!");
+    case cipher_status::empty_text:
+        throw cipher_error("Empty cipher text");
+    case cipher_status::invalid_text:
+        throw cipher_error("Неправильный зашифрованный текст!");
+    case cipher_status::bad_encoding:
+        throw cipher_error("Некорректная кодировка UTF-8");
+    case cipher_status::small_buffer:
+        throw cipher_error("Недостаточный размер буфера");
+    }
+}
+
+/**
+ * @brief Шифрование текста
+ * @param open_text Открытый текст
+ * @return Зашифрованная строка
+ */
+std::string productCipher::encrypt(const std::string& open_text) const {
+    std::string result(open_text.size(), '\0');
+    cipher_result r = encrypt_into(open_text, &result[0], result.size());
+    check(r.status);
+    result.resize(r.size);
+    return result;
+}
+
+/**
+ * @brief Расшифрование текста
+ * @param cipher_text Зашифрованный текст
+ * @return Расшифрованная строка
+ */
+std::string productCipher::decrypt(const std::string& cipher_text) const {
+    std::string result(cipher_text.size(), '\0');
+    check(decrypt_into(cipher_text, &result[0], result.size()).status);
+    return result;
+}
+
+/**
+ * @brief Подсчитывает русские буквы (А..я) в UTF-8 тексте без полной проверки
+ * @param in Текст
+ * @param n Размер в байтах
+ * @return Количество букв, которые будут зашифрованы
+ */
+static size_t countLetters(const unsigned char* in, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i + 1 < n; i++)
+        count += (in[i] == 0xD0 && in[i + 1] >= 0x90) || (in[i] == 0xD1 && in[i + 1] >= 0x80 && in[i + 1] < 0x90);
+    return count;
+}
+
+/**
+ * @brief Определяет длину UTF-8 последовательности и проверяет её целостность
+ * @return Длина последовательности в байтах или 0, если она некорректна или обрезана
+ */
+static inline size_t utf8Length(const unsigned char* in, size_t i, size_t n) {
+    unsigned char b = in[i];
+    size_t len = b < 0x80 ? 1 : b < 0xC2 ? 0 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF5 ? 4 : 0;
+    if (i + len > n)
+        return 0;
+    for (size_t j = 1; j < len; j++)
+        if ((in[i + j] & 0xC0) != 0x80)
+            return 0;
+    return len;
+}
+
+cipher_result productCipher::encrypt_into(std::string_view open_text, char* out, size_t out_size) const noexcept {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(open_text.data());
+    size_t n = open_text.size();
+    size_t letters = countLetters(src, n);
+    if (2 * letters > out_size)
+        return {0, cipher_status::small_buffer};
+
+    const alphaTable& alpha = modAlphaCipher::alpha;
+    const size_t keyLen = subst.key.size();
+    const size_t rows = letters / columns;
+    const size_t full = rows * columns;
+    // Блок из целых строк таблицы: каждый столбец блока записывается непрерывным отрезком
+    const size_t blockLetters = columns <= blockSize ? blockSize / columns * columns : blockSize;
+    unsigned char block[blockSize];
+    size_t count = 0, k = 0, pos = 0;
+    // Сдвигает накопленный блок ядром и записывает буквы сразу на места после перестановки
+    auto flush = [&] {
+        shiftAdd(block, count, subst.encStream.data(), keyLen, pos);
+        pos = (pos + count) % keyLen;
+        if (k % columns == 0 && count % columns == 0 && k + count <= full) {
+            size_t blockRows = count / columns;
+            for (size_t j = 0; j < columns; j++) {
+                char* dst = out + 2 * ((columns - 1 - j) * rows + k / columns);
+                for (size_t r = 0; r < blockRows; r++)
+                    std::memcpy(dst + 2 * r, alpha.utf8[block[r * columns + j]], 2);
+            }
+            k += count;
+        } else {
+            for (size_t q = 0; q < count; q++, k++) {
+                size_t p = k < full ? (columns - 1 - k % columns) * rows + k / columns : k;
+                std::memcpy(out + 2 * p, alpha.utf8[block[q]], 2);
+            }
+        }
+        count = 0;
+    };
+    for (size_t b = 0; b < n;) {
+        size_t len = utf8Length(src, b, n);
+        if (len == 0)
+            return {0, cipher_status::bad_encoding};
+        if (len == 2) {
+            wchar_t c = ((src[b] & 0x1F) << 6) | (src[b + 1] & 0x3F);
+            if (c >= L'А' && c <= L'я') {
+                block[count++] = alpha.index(c >= L'а' ? c - 32 : c);
+                if (count == blockLetters)
+                    flush();
+            }
+        }
+        b += len;
+    }
+    flush();
+    if (k == 0)
+        return {0, cipher_status::no_text};
+    return {2 * k, cipher_status::ok};
+}
+
+/**
+ * @brief Возвращает номер прописной буквы, записанной в UTF-8 двумя байтами
+ * @return Номер 0..32 или -1 для недопустимого символа
+ */
+static inline int letterAt(const unsigned char* s) {
+    if (s[0] == 0xD0 && (s[1] & 0xC0) == 0x80)
+        return modAlphaCipher::alpha.index(0x400 | (s[1] & 0x3F));
+    return -1;
+}
+
+cipher_result productCipher::decrypt_into(std::string_view cipher_text, char* out, size_t out_size) const noexcept {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(cipher_text.data());
+    size_t n = cipher_text.size();
+    if (n == 0)
+        return {0, cipher_status::empty_text};
+    if (n % 2)
+        return {0, cipher_status::invalid_text};
+    if (n > out_size)
+        return {0, cipher_status::small_buffer};
+
+    const alphaTable& alpha = modAlphaCipher::alpha;
+    const size_t keyLen = subst.key.size();
+    const size_t letters = n / 2;
+    const size_t rows = letters / columns;
+    const size_t full = rows * columns;
+    const size_t blockLetters = columns <= blockSize ? blockSize / columns * columns : blockSize;
+    unsigned char block[blockSize];
+    size_t pos = 0;
+    for (size_t k = 0; k < letters;) {
+        size_t count = std::min(blockLetters, letters - k);
+        // Буква k расшифрованного текста читается из позиции p шифртекста;
+        // целые строки таблицы читаются отрезками столбцов
+        bool ok = true;
+        if (k % columns == 0 && count % columns == 0 && k + count <= full) {
+            size_t blockRows = count / columns;
+            for (size_t j = 0; j < columns; j++) {
+                const unsigned char* from = src + 2 * ((columns - 1 - j) * rows + k / columns);
+                for (size_t r = 0; r < blockRows; r++) {
+                    int v = letterAt(from + 2 * r);
+                    ok &= v >= 0;
+                    block[r * columns + j] = static_cast<unsigned char>(v);
+                }
+            }
+        } else {
+            for (size_t q = 0; q < count; q++) {
+                size_t p = k + q < full ? (columns - 1 - (k + q) % columns) * rows + (k + q) / columns : k + q;
+                int v = letterAt(src + 2 * p);
+                ok &= v >= 0;
+                block[q] = static_cast<unsigned char>(v);
+            }
+        }
+        if (!ok)
+            return {0, cipher_status::invalid_text};
+        shiftAdd(block, count, subst.decStream.data(), keyLen, pos);
+        pos = (pos + count) % keyLen;
+        for (size_t q = 0; q < count; q++, k++)
+            std::memcpy(out + 2 * k, alpha.utf8[block[q]], 2);
+    }
+    return {n, cipher_status::ok};
+}
@@ -0,0 +1,79 @@
+/**
+ * @file productCipher.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Составной шифр: Гронсфельд и табличная маршрутная перестановка за один проход
+ * @warning Реализация только для русского языка (алфавит: А-Я, Ё)
+ */
+
+#pragma once
+#include "modAlphaCipher.h"
+
+/**
+ * @class productCipher
+ * @brief Шифр Гронсфельда, результат которого переставляется по маршруту таблицы
+ * @details Результат совпадает с последовательным применением modAlphaCipher::encrypt
+ *          и маршрутной перестановки code (Lab 4.2) к буквам шифртекста: буквы
+ *          записываются в таблицу из routeKey столбцов по строкам и читаются по
+ *          столбцам справа налево, сверху вниз; буквы за последней полной строкой
+ *          остаются на своих местах. Вместо двух проходов с промежуточным буфером
+ *          буквы сдвигаются блоками в стеке ядром shiftAdd и сразу записываются в
+ *          свои позиции после перестановки, при расшифровании - читаются из них.
+ *          Шифрованию нужно число букв до первой записи, поэтому вход
+ *          предварительно просматривается без записи.
+ */
+class productCipher {
+public:
+    productCipher() = delete; ///< Запрет конструктора без параметров
+
+    /**
+     * @brief Конструктор
+     * @param skey Ключ шифра Гронсфельда
+     * @param routeKey Количество столбцов таблицы перестановки
+     * @throw cipher_error Если ключ Гронсфельда недопустим или routeKey меньше 2
+     */
+    productCipher(const std::string& skey, int routeKey);
+
+    /**
+     * @brief Шифрует открытый текст
+     * @param open_text Текст для шифрования в UTF-8
+     * @return Зашифрованная строка (в верхнем регистре)
+     * @throw cipher_error Если текст пустой, не содержит букв или некорректен
+     */
+    std::string encrypt(const std::string& open_text) const;
+
+    /**
+     * @brief Расшифровывает зашифрованный текст
+     * @param cipher_text Зашифрованный текст
+     * @return Расшифрованная строка (в верхнем регистре)
+     * @throw cipher_error Если текст пустой или содержит недопустимые символы
+     */
+    std::string decrypt(const std::string& cipher_text) const;
+
+    /**
+     * @brief Шифрует текст в буфер вызывающей стороны без выделения памяти
+     * @details Буфера размером open_text.size() всегда достаточно.
+     *          Исключения не выбрасываются.
+     * @param open_text Текст для шифрования
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result encrypt_into(std::string_view open_text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Расшифровывает текст в буфер вызывающей стороны без выделения памяти
+     * @details Символы проверяются при чтении из переставленных позиций.
+     *          Исключения не выбрасываются.
+     * @param cipher_text Зашифрованный текст
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result decrypt_into(std::string_view cipher_text, char* out, size_t out_size) const noexcept;
+
+private:
+    modAlphaCipher subst; ///< Шифр Гронсфельда (ключ и потоки ключа)
+    size_t columns;       ///< Количество столбцов таблицы перестановки
+};
@@ -0,0 +1,269 @@
+/**
+ * @file staticAlphaCipher.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Шифр Гронсфельда с ключом, известным на этапе компиляции
+ * @details Ключ передаётся шаблонным параметром, проверяется static_assert и
+ *          разворачивается в расписание сдвигов на этапе компиляции. Строковые
+ *          литералы можно шифровать в constexpr-контексте, а во время выполнения
+ *          цикл сдвига развёрнут на длину ключа и не содержит деления.
+ */
+
+#pragma once
+#include "modAlphaCipher.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @struct staticText
+ * @brief Результат преобразования фиксированной ёмкости, пригодный для constexpr
+ * @tparam N Ёмкость буфера в байтах
+ */
+template <size_t N>
+struct staticText {
+    char data[N] {}; ///< Байты результата в UTF-8
+    size_t size = 0; ///< Количество записанных байт
+
+    /// Результат в виде строки
+    constexpr std::string_view view() const {
+        return std::string_view(data, size);
+    }
+};
+
+namespace staticCipherDetail {
+
+/// Длина UTF-8 последовательности по первому байту (1 для некорректных байт)
+constexpr size_t leadLength(unsigned char b) {
+    return b < 0xC0 ? 1 : b < 0xE0 ? 2 : b < 0xF0 ? 3 : 4;
+}
+
+/// Номер буквы А..я (строчные приводятся к прописным) в позиции i или -1
+constexpr int letterAt(const char* s, size_t i, size_t n) {
+    unsigned char b = s[i];
+    if (leadLength(b) != 2 || i + 1 >= n)
+        return -1;
+    wchar_t c = ((b & 0x1F) << 6) | (static_cast<unsigned char>(s[i + 1]) & 0x3F);
+    if (c < L'А' || c > L'я')
+        return -1;
+    return modAlphaCipher::alpha.index(c >= L'а' ? c - 32 : c);
+}
+
+/// Длина строки с завершающим нулём
+constexpr size_t length(const char* s) {
+    size_t n = 0;
+    while (s[n])
+        n++;
+    return n;
+}
+
+/// Количество букв ключа
+constexpr size_t keyLength(const char* key) {
+    size_t n = length(key);
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += leadLength(key[i]))
+        count++;
+    return count;
+}
+
+/// Ключ состоит только из русских букв
+constexpr bool keyLetters(const char* key) {
+    size_t n = length(key);
+    for (size_t i = 0; i < n; i += leadLength(key[i]))
+        if (letterAt(key, i, n) < 0)
+            return false;
+    return true;
+}
+
+/// Ключ длиннее одной буквы и все его буквы одинаковы
+constexpr bool keyWeak(const char* key) {
+    size_t n = length(key);
+    if (!keyLetters(key) || keyLength(key) < 2)
+        return false;
+    for (size_t i = 2; i < n; i += 2)
+        if (letterAt(key, i, n) != letterAt(key, 0, n))
+            return false;
+    return true;
+}
+
+/// Расписание сдвигов: номера букв ключа либо (33 - k) mod 33 для расшифрования
+template <size_t P>
+constexpr std::array<unsigned char, P> schedule(const char* key, bool inverse) {
+    std::array<unsigned char, P> result {};
+    size_t n = length(key);
+    for (size_t i = 0, j = 0; j < P; i += 2, j++) {
+        int k = letterAt(key, i, n);
+        result[j] = static_cast<unsigned char>(inverse ? (alphaTable::size - k) % alphaTable::size : k);
+    }
+    return result;
+}
+
+} // namespace staticCipherDetail
+
+/**
+ * @class staticAlphaCipher
+ * @brief Шифр Гронсфельда с ключом-параметром шаблона
+ * @details Ключ задаётся массивом со статическим временем жизни, например:
+ *          @code
+ *          static constexpr char tag[] = "КЛЮЧ";
+ *          constexpr auto secret = staticAlphaCipher<tag>::encrypt("ПРИВЕТ");
+ *          @endcode
+ *          Результаты совпадают с modAlphaCipher с тем же ключом.
+ * @tparam Key Ключ в UTF-8 (только русские буквы, регистр не важен)
+ */
+template <const char* Key>
+class staticAlphaCipher {
+public:
+    static constexpr size_t period = staticCipherDetail::keyLength(Key); ///< Длина ключа в буквах
+
+    static_assert(period > 0, "Пустой ключ");
+    static_assert(staticCipherDetail::keyLetters(Key), "Неверный ключ: содержит не-буквенные символы");
+    static_assert(!staticCipherDetail::keyWeak(Key), "WeakKey");
+
+    static constexpr std::array<unsigned char, period> encSchedule =
+        staticCipherDetail::schedule<period>(Key, false); ///< Сдвиги при шифровании
+    static constexpr std::array<unsigned char, period> decSchedule =
+        staticCipherDetail::schedule<period>(Key, true); ///< Сдвиги при расшифровании
+
+    staticAlphaCipher() = delete; ///< Все методы статические
+
+    /**
+     * @brief Шифрует строковый литерал (может вычисляться на этапе компиляции)
+     * @param text Открытый текст
+     * @return Зашифрованный текст
+     * @throw cipher_error Если текст не содержит букв (при constexpr - ошибка компиляции)
+     */
+    template <size_t N>
+    static constexpr staticText<N> encrypt(const char (&text)[N]) {
+        staticText<N> result;
+        size_t pos = 0;
+        for (size_t i = 0; i + 1 < N; i += staticCipherDetail::leadLength(text[i])) {
+            int v = staticCipherDetail::letterAt(text, i, N - 1);
+            if (v < 0)
+                continue;
+            v += encSchedule[pos];
+            if (v >= alphaTable::size)
+                v -= alphaTable::size;
+            if (++pos == period)
+                pos = 0;
+            result.data[result.size++] = modAlphaCipher::alpha.utf8[v][0];
+            result.data[result.size++] = modAlphaCipher::alpha.utf8[v][1];
+        }
+        if (result.size == 0)
+            throw cipher_error("Отсутствует открытый текст!");
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывает строковый литерал (может вычисляться на этапе компиляции)
+     * @param text Зашифрованный текст
+     * @return Расшифрованный текст
+     * @throw cipher_error Если текст пустой или содержит символы вне алфавита
+     */
+    template <size_t N>
+    static constexpr staticText<N> decrypt(const char (&text)[N]) {
+        staticText<N> result;
+        if (N < 2)
+            throw cipher_error("Empty cipher text");
+        for (size_t i = 0; i + 1 < N; i += 2) {
+            int v = cipherLetter(static_cast<unsigned char>(text[i]), static_cast<unsigned char>(text[i + 1]));
+            if (v < 0)
+                throw cipher_error("Неправильный зашифрованный текст!");
+            v += decSchedule[i / 2 % period];
+            if (v >= alphaTable::size)
+                v -= alphaTable::size;
+            result.data[result.size++] = modAlphaCipher::alpha.utf8[v][0];
+            result.data[result.size++] = modAlphaCipher::alpha.utf8[v][1];
+        }
+        return result;
+    }
+
+    /**
+     * @brief Шифрует текст во время выполнения
+     * @param open_text Открытый текст в UTF-8
+     * @return Зашифрованная строка
+     * @throw cipher_error Если текст не содержит букв
+     */
+    static std::string encrypt(std::string_view open_text) {
+        std::string result(open_text.size(), '\0');
+        unsigned char block[blockSize];
+        size_t count = 0;
+        size_t written = 0;
+        for (size_t i = 0; i < open_text.size(); i += staticCipherDetail::leadLength(open_text[i])) {
+            int v = staticCipherDetail::letterAt(open_text.data(), i, open_text.size());
+            if (v < 0)
+                continue;
+            block[count++] = static_cast<unsigned char>(v);
+            if (count == blockSize) {
+                written += flush(block, count, &result[written], encSchedule);
+                count = 0;
+            }
+        }
+        written += flush(block, count, &result[written], encSchedule);
+        if (written == 0)
+            throw cipher_error("Отсутствует открытый текст!");
+        result.resize(written);
+        return result;
+    }
+
+    /**
+     * @brief Расшифровывает текст во время выполнения
+     * @param cipher_text Зашифрованный текст в UTF-8
+     * @return Расшифрованная строка
+     * @throw cipher_error Если текст пустой или содержит символы вне алфавита
+     */
+    static std::string decrypt(std::string_view cipher_text) {
+        if (cipher_text.empty())
+            throw cipher_error("Empty cipher text");
+        if (cipher_text.size() % 2)
+            throw cipher_error("Неправильный зашифрованный текст!");
+        std::string result(cipher_text.size(), '\0');
+        unsigned char block[blockSize];
+        for (size_t i = 0; i < cipher_text.size();) {
+            size_t count = std::min(blockSize, (cipher_text.size() - i) / 2);
+            for (size_t j = 0; j < count; j++, i += 2) {
+                int v = cipherLetter(static_cast<unsigned char>(cipher_text[i]),
+                                     static_cast<unsigned char>(cipher_text[i + 1]));
+                if (v < 0)
+                    throw cipher_error("Неправильный зашифрованный текст!");
+                block[j] = static_cast<unsigned char>(v);
+            }
+            flush(block, count, &result[i - 2 * count], decSchedule);
+        }
+        return result;
+    }
+
+private:
+    /// Размер блока в буквах: кратен длине ключа, поэтому каждый блок начинается с фазы 0
+    static constexpr size_t blockSize = (4096 / period + 1) * period;
+
+    /// Номер буквы зашифрованного текста (прописные и Ё) или -1
+    static constexpr int cipherLetter(unsigned char lead, unsigned char next) {
+        return lead == 0xD0 && (next & 0xC0) == 0x80 ? modAlphaCipher::alpha.index(0x400 | (next & 0x3F)) : -1;
+    }
+
+    /// Сдвигает блок циклом, развёрнутым на длину ключа, и кодирует его в UTF-8
+    static size_t flush(unsigned char* block, size_t count, char* out,
+                        const std::array<unsigned char, period>& shifts) {
+        size_t i = 0;
+        for (; i + period <= count; i += period)
+            for (size_t j = 0; j < period; j++)
+                block[i + j] = add(block[i + j], shifts[j]);
+        for (size_t j = 0; i + j < count; j++)
+            block[i + j] = add(block[i + j], shifts[j]);
+        for (size_t k = 0; k < count; k++) {
+            out[2 * k] = modAlphaCipher::alpha.utf8[block[k]][0];
+            out[2 * k + 1] = modAlphaCipher::alpha.utf8[block[k]][1];
+        }
+        return 2 * count;
+    }
+
+    /// Сложение по модулю 33 условным вычитанием
+    static constexpr unsigned char add(unsigned char a, unsigned char k) {
+        unsigned v = a + k;
+        return static_cast<unsigned char>(v >= alphaTable::size ? v - alphaTable::size : v);
+    }
+};
@@ -0,0 +1,281 @@
+/**
+ * @file bench.cpp
+ * @author Ваше Имя
+ * @version 1.0
+ * @date 2025-12-09
+ * @brief Замер производительности класса code
+ * @details Сравнивает прежнюю перестановку через таблицу char** (отдельная строка
+ *          new char[key] на каждую строку таблицы) с прямым вычислением позиции
+ *          символа в code::encryption/transcript и перестановкой на месте, кэшированные
+ *          перестановки на коротких сообщениях, а также
+ *          поэлементную перестановку с блочным транспонированием при длине текста
+ *          от 1 КБ до 1 ГБ и ключе от 2 до 4096 столбцов. Маршруты из routePolicy.h
+ *          сравниваются с теми же маршрутами, написанными вручную; многопоточное
+ *          шифрование замеряется на текстах от 1 до 256 МБ.
+ *          Сборка: g++ -std=c++17 -O2 bench.cpp route.cpp -o bench
+ *          Запуск: ./bench [размер текста] [максимальный размер для развёртки] [--stats]
+ *          С --stats (и сборкой с -DCIPHER_STATS) в конце печатается статистика этапов шифров.
+ */
+
+#include "route.h"
+#include "../../cipherlib/cipherStats.h"
+#include "../../cipherlib/routePolicy.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Прежняя реализация шифрования через таблицу char**
+ * @param t Текст без пробелов
+ * @param key Количество столбцов
+ * @return Зашифрованная строка
+ */
+static string tableEncryption(string t, int key)
+{
+    int k = 0;
+    int simvoli = t.size();
+    int stroki = simvoli / key;
+    char** tabl = new char* [stroki];
+    for (int i = 0; i < stroki; i++)
+        tabl[i] = new char [key];
+    for (int i = 0; i < stroki; i++)
+        for (int j = 0; j < key; j++)
+            tabl[i][j] = t[k++];
+    k = 0;
+    for (int j = key - 1; j >= 0 ; j--)
+        for (int i = 0; i < stroki; i++)
+            t[k++] = tabl[i][j];
+    for (int i = 0; i < stroki; i++)
+        delete[] tabl[i];
+    delete[] tabl;
+    return t;
+}
+
+/**
+ * @brief Поэлементная перестановка без блокирования (чтение столбцов с шагом key)
+ * @param in Текст без пробелов
+ * @param out Результат
+ * @param n Длина текста
+ * @param key Количество столбцов
+ */
+static void naiveRoute(const char* in, char* out, size_t n, size_t key)
+{
+    size_t rows = n / key;
+    size_t k = 0;
+    for (size_t j = key; j-- > 0;)
+        for (size_t i = 0; i < rows; i++)
+            out[k++] = in[i * key + j];
+    for (; k < n; k++)
+        out[k] = in[k];
+}
+
+/**
+ * @brief Маршрут "змейка", написанный вручную (для сравнения с route::snake)
+ * @param in Текст
+ * @param out Результат
+ * @param n Длина текста (кратна key)
+ * @param key Количество столбцов
+ */
+static void handSnake(const char* in, char* out, size_t n, size_t key)
+{
+    size_t rows = n / key;
+    size_t k = 0;
+    for (size_t j = key; j-- > 0;) {
+        if ((key - 1 - j) % 2 == 0)
+            for (size_t i = 0; i < rows; i++)
+                out[k++] = in[i * key + j];
+        else
+            for (size_t i = rows; i-- > 0;)
+                out[k++] = in[i * key + j];
+    }
+}
+
+/**
+ * @brief Измеряет время выполнения функции
+ * @param f Замеряемая функция
+ * @return Время в секундах
+ */
+template <class F>
+static double measure(F f)
+{
+    auto start = chrono::steady_clock::now();
+    f();
+    chrono::duration<double> d = chrono::steady_clock::now() - start;
+    return d.count();
+}
+
+/**
+ * @brief Выводит строку результата
+ * @param name Название замера
+ * @param bytes Объём обработанных данных
+ * @param seconds Время
+ */
+static void report(const string& name, size_t bytes, double seconds)
+{
+    cout << name << ": " << bytes / seconds / 1e6 << " MB/s" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    // --stats допускается в любом месте, остальные аргументы позиционные
+    bool stats = false;
+    int args = 1;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--stats")
+            stats = true;
+        else
+            argv[args++] = argv[i];
+    }
+    argc = args;
+    size_t bytes = argc > 1 ? strtoull(argv[1], nullptr, 10) : 8u << 20;
+    string text(bytes, 'a');
+    for (size_t i = 0; i < bytes; i++)
+        text[i] = 'a' + i * 7 % 26;
+
+    for (int key : {3, 16, 64, 1024}) {
+        code cipher(key, text);
+        string table, direct, decrypted;
+        double tTable = measure([&] { table = tableEncryption(text, key); });
+        double tDirect = measure([&] { direct = cipher.encryption(text); });
+        double tDecrypt = measure([&] { decrypted = cipher.transcript(direct, text); });
+        if (table != direct || decrypted != text) {
+            cerr << "Результаты не совпадают для ключа " << key << endl;
+            return 1;
+        }
+        string suffix = " key " + to_string(key);
+        report("table encryption" + suffix, bytes, tTable);
+        report("direct encryption" + suffix, bytes, tDirect);
+        report("direct transcript" + suffix, bytes, tDecrypt);
+        string inPlace = text;
+        report("in-place encryption" + suffix, bytes,
+               measure([&] { cipher.encryption_in_place(&inPlace[0], inPlace.size()); }));
+        if (inPlace != direct) {
+            cerr << "Результаты на месте не совпадают для ключа " << key << endl;
+            return 1;
+        }
+    }
+
+    // Короткие сообщения повторяющихся длин: перестановка из кэша против транспонирования
+    {
+        code cipher(7, "ABCDEFG");
+        vector<string> messages;
+        size_t total = 0;
+        for (size_t i = 0; i < 200000; i++) {
+            messages.push_back(text.substr(i % 1000, 20 + i % 181));
+            total += messages.back().size();
+        }
+        string out(256, '\0');
+        report("short messages table", total, measure([&] {
+            for (auto& m : messages)
+                tableEncryption(m, 7);
+        }));
+        report("short messages transpose", total, measure([&] {
+            for (auto& m : messages)
+                cipher.encryption_into(m, &out[0], out.size());
+        }));
+        report("short messages cached", total, measure([&] {
+            for (auto& m : messages)
+                cipher.encryption(m);
+        }));
+        permutationCache::stats st = code::permutations().statistics();
+        cout << "cache hits " << st.hits << " misses " << st.misses << " bytes " << st.bytes << endl;
+    }
+
+    // Маршруты-стратегии против написанных вручную циклов
+    {
+        auto any = [](char) { return true; };
+        string hand(bytes, '\0'), policy(bytes, '\0');
+        for (size_t key : {16, 1024}) {
+            size_t n = bytes / key * key;
+            string suffix = " key " + to_string(key);
+            report("hand snake" + suffix, n, measure([&] { handSnake(text.data(), &hand[0], n, key); }));
+            report("policy snake" + suffix, n, measure([&] {
+                route::routeKernel<route::snake>::apply(text.data(), &policy[0], n, key, false, any);
+            }));
+            if (hand != policy) {
+                cerr << "Маршрут snake не совпадает для ключа " << key << endl;
+                return 1;
+            }
+            report("hand columns" + suffix, n, measure([&] { naiveRoute(text.data(), &hand[0], n, key); }));
+            report("policy columns walk" + suffix, n, measure([&] {
+                route::routeWalk<route::columnsRightToLeft>(text.data(), &policy[0], n, key, false, any);
+            }));
+            report("policy columns kernel" + suffix, n, measure([&] {
+                route::routeKernel<route::columnsRightToLeft>::apply(text.data(), &policy[0], n, key, false, any);
+            }));
+            if (hand != policy) {
+                cerr << "Маршрут columns не совпадает для ключа " << key << endl;
+                return 1;
+            }
+            report("policy spiral" + suffix, n, measure([&] {
+                route::routeKernel<route::spiral>::apply(text.data(), &policy[0], n, key, false, any);
+            }));
+            report("policy zigzag" + suffix, n, measure([&] {
+                route::routeKernel<route::zigzag>::apply(text.data(), &policy[0], n, key, false, any);
+            }));
+        }
+    }
+
+    // Многопоточный режим: полосы строк против одного потока
+    for (size_t size : {size_t(1) << 20, size_t(10) << 20, size_t(64) << 20, size_t(256) << 20}) {
+        if (size > max(bytes, size_t(64) << 20))
+            break;
+        string big(size, 'a');
+        for (size_t i = 0; i < size; i++)
+            big[i] = 'a' + i * 7 % 26;
+        for (int key : {16, 1024}) {
+            code cipher(key, big);
+            size_t saved = code::parallelThreshold;
+            code::parallelThreshold = 0;
+            string single = cipher.encryption(big, 1);
+            for (unsigned threads = 1; threads <= max(4u, thread::hardware_concurrency()); threads *= 2) {
+                string parallel;
+                double t = measure([&] { parallel = cipher.encryption(big, threads); });
+                if (parallel != single) {
+                    cerr << "Многопоточный результат не совпадает для ключа " << key << endl;
+                    return 1;
+                }
+                report("parallel encryption " + to_string(size) + " B key " + to_string(key) + " " +
+                       to_string(threads) + " threads", size, t);
+            }
+            code::parallelThreshold = saved;
+        }
+    }
+
+    // Развёртка по длине текста и ширине таблицы
+    size_t maxSweep = argc > 2 ? strtoull(argv[2], nullptr, 10) : size_t(1) << 30;
+    string sweep(min(maxSweep, size_t(1) << 30), 'a');
+    for (size_t i = 0; i < sweep.size(); i++)
+        sweep[i] = 'a' + i * 7 % 26;
+    string naive(sweep.size(), '\0');
+    string tiled(sweep.size(), '\0');
+    for (size_t size = 1 << 10; size <= sweep.size(); size <<= 5) {
+        string_view view(sweep.data(), size);
+        size_t repeat = max<size_t>(1, (size_t(64) << 20) / size);
+        for (int key : {2, 16, 128, 1024, 4096}) {
+            if (size_t(key) > size)
+                break;
+            size_t rows = size / key;
+            double tNaive = measure([&] {
+                for (size_t r = 0; r < repeat; r++)
+                    naiveRoute(view.data(), &naive[0], size, key);
+            });
+            double tTiled = measure([&] {
+                for (size_t r = 0; r < repeat; r++)
+                    transposeBytes(view.data(), key, 1, &tiled[(key - 1) * rows], -ptrdiff_t(rows), 1, rows, key);
+            });
+            if (naive.compare(0, rows * key, tiled, 0, rows * key) != 0) {
+                cerr << "Результаты не совпадают для ключа " << key << endl;
+                return 1;
+            }
+            string suffix = " " + to_string(size) + " B key " + to_string(key);
+            report("naive" + suffix, size * repeat, tNaive);
+            report("tiled" + suffix, size * repeat, tTiled);
+        }
+    }
+    if (stats)
+        cipherStats::print(cout, cipherStats::take());
+    return 0;
+}
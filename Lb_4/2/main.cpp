@@ -8,8 +8,18 @@
  */
 
 #include <UnitTest++/UnitTest++.h>
+#include "../../cipherlib/allocationTracker.h"
 #include "route.h"
+#include "../../cipherlib/cipherStats.h"
+#include "../../cipherlib/routePolicy.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
 #include <string>
+#include <thread>
 
 /// Тесты для конструктора и ключа
 SUITE(KeyTest) {
@@ -101,6 +111,18 @@ SUITE(DecryptTest) {
         std::string original = "";
         CHECK_THROW(t->transcript(encrypted, original), cipher_error);
     }
+    TEST_FIXTURE(KeyThree_fixture, BothTextsInvalid) {
+        // Как и прежде, первой сообщается ошибка в шифртексте
+        for (std::string original : {"HEL2O", "HEL2OO"}) {
+            std::string message;
+            try {
+                t->transcript("LE1LO", original);
+            } catch (const cipher_error& e) {
+                message = e.what();
+            }
+            CHECK_EQUAL("Некорректные символы в зашифрованном тексте!", message);
+        }
+    }
     TEST(SquareTableDecrypt) {
         code cipher(4, "PROGRAM");
         std::string encrypted = "GORPRAM";
@@ -109,6 +131,468 @@ SUITE(DecryptTest) {
     }
 }
 
+/// Тесты записи в буфер вызывающей стороны
+SUITE(IntoTest) {
+    TEST_FIXTURE(KeyThree_fixture, EncryptionInto) {
+        char out[16];
+        cipher_result r = t->encryption_into("HE LL O", out, sizeof out);
+        CHECK(r.status == cipher_status::ok);
+        CHECK_EQUAL("LEHLO", std::string(out, r.size));
+    }
+    TEST(EncryptionIntoMatches) {
+        std::string text = "TheQuickBrownFoxJumpsOverTheLazyDog";
+        for (int key = 2; key <= 35; key++) {
+            code cipher(key, text);
+            std::string out(text.size(), ' ');
+            cipher_result r = cipher.encryption_into(text, &out[0], out.size());
+            CHECK_EQUAL(cipher.encryption(text), out.substr(0, r.size));
+            std::string back(text.size(), ' ');
+            r = cipher.transcript_into(out, text, &back[0], back.size());
+            CHECK_EQUAL(cipher.transcript(out, text), back.substr(0, r.size));
+        }
+    }
+    TEST_FIXTURE(KeyThree_fixture, ErrorCodes) {
+        char out[4];
+        CHECK(t->encryption_into("", out, sizeof out).status == cipher_status::no_text);
+        CHECK(t->encryption_into("HE1LO", out, sizeof out).status == cipher_status::invalid_text);
+        CHECK(t->encryption_into("HELLO", out, sizeof out).status == cipher_status::small_buffer);
+        CHECK(t->transcript_into("LEH LO", "HELLO", out, sizeof out).status == cipher_status::invalid_text);
+        CHECK(t->transcript_into("SHORT", "LONGER", out, sizeof out).status == cipher_status::bad_length);
+        CHECK(t->transcript_into("LEHLO", "HELLO", out, sizeof out).status == cipher_status::small_buffer);
+    }
+    TEST_FIXTURE(KeyThree_fixture, NoAllocations) {
+        std::string text(100000, 'A');
+        for (size_t i = 0; i < text.size(); i++)
+            text[i] = 'a' + i % 26;
+        std::string encrypted(text.size(), ' ');
+        std::string decrypted(text.size(), ' ');
+        allocationScope scope;
+        cipher_result e = t->encryption_into(text, &encrypted[0], encrypted.size());
+        cipher_result d = t->transcript_into(encrypted, text, &decrypted[0], decrypted.size());
+        t->encryption_into("HE1LO", &encrypted[0], encrypted.size());
+        CHECK_EQUAL(size_t(0), scope.allocations());
+        CHECK(e.status == cipher_status::ok);
+        CHECK(d.status == cipher_status::ok);
+        CHECK(text == decrypted);
+    }
+}
+
+SUITE(InPlaceTest) {
+    TEST_FIXTURE(KeyThree_fixture, EncryptionInPlace) {
+        char text[] = "HE LL O";
+        cipher_result r = t->encryption_in_place(text, 7);
+        CHECK(r.status == cipher_status::ok);
+        CHECK_EQUAL("LEHLO", std::string(text, r.size));
+    }
+    TEST(InPlaceMatches) {
+        std::string text = "TheQuickBrownFoxJumpsOverTheLazyDog";
+        for (int key = 2; key <= 35; key++) {
+            code cipher(key, text);
+            std::string buffer = text;
+            cipher_result r = cipher.encryption_in_place(&buffer[0], buffer.size());
+            CHECK_EQUAL(cipher.encryption(text), buffer.substr(0, r.size));
+            r = cipher.transcript_in_place(&buffer[0], buffer.size(), text);
+            CHECK(r.status == cipher_status::ok);
+            CHECK_EQUAL(text, buffer);
+        }
+    }
+    TEST(LargeText) {
+        std::string text(1 << 20, 'a');
+        for (size_t i = 0; i < text.size(); i++)
+            text[i] = 'a' + i * 7 % 26;
+        code cipher(1000, text);
+        std::string buffer = text;
+        cipher.encryption_in_place(&buffer[0], buffer.size());
+        CHECK_EQUAL(cipher.encryption(text), buffer);
+        cipher.transcript_in_place(&buffer[0], buffer.size(), text);
+        CHECK_EQUAL(text, buffer);
+    }
+    TEST_FIXTURE(KeyThree_fixture, ErrorsKeepText) {
+        char text[] = "HE1LO";
+        CHECK(t->encryption_in_place(text, 5).status == cipher_status::invalid_text);
+        CHECK_EQUAL("HE1LO", std::string(text));
+        char cipherText[] = "LEHLO";
+        CHECK(t->transcript_in_place(cipherText, 5, "HELL").status == cipher_status::bad_length);
+        CHECK_EQUAL("LEHLO", std::string(cipherText));
+        CHECK(t->encryption_in_place(text, 0).status == cipher_status::no_text);
+    }
+}
+
+SUITE(KeyOnlyDecryptTest) {
+    TEST_FIXTURE(KeyThree_fixture, WithoutOpenText) {
+        CHECK_EQUAL("HELLO", t->transcript("LEHLO"));
+    }
+    TEST(MatchesTwoArgument) {
+        std::string text = "TheQuickBrownFoxJumpsOverTheLazyDog";
+        for (int key = 2; key <= 35; key++) {
+            code cipher(key, text);
+            std::string encrypted = cipher.encryption(text);
+            CHECK_EQUAL(cipher.transcript(encrypted, text), cipher.transcript(encrypted));
+            std::string out(text.size(), ' ');
+            cipher_result r = cipher.transcript_into(encrypted, &out[0], out.size());
+            CHECK(r.status == cipher_status::ok);
+            CHECK_EQUAL(text, out);
+        }
+    }
+    TEST_FIXTURE(KeyThree_fixture, InvalidCharacters) {
+        CHECK_THROW(t->transcript("LEH LO"), cipher_error);
+        CHECK_THROW(t->transcript("LEH1O"), cipher_error);
+        CHECK_THROW(t->transcript(""), cipher_error);
+        char out[8];
+        CHECK(t->transcript_into("LEH1O", out, sizeof out).status == cipher_status::invalid_text);
+        CHECK(t->transcript_into("", out, sizeof out).status == cipher_status::no_text);
+        CHECK(t->transcript_into("LEHLOLEHLO", out, sizeof out).status == cipher_status::small_buffer);
+    }
+    TEST(InvalidInLargeText) {
+        std::string text(1 << 20, 'a');
+        for (size_t i = 0; i < text.size(); i++)
+            text[i] = 'a' + i * 7 % 26;
+        code cipher(100, text);
+        std::string encrypted = cipher.encryption(text);
+        CHECK_EQUAL(text, cipher.transcript(encrypted));
+        for (size_t pos : {size_t(0), size_t(12345), encrypted.size() - 1}) {
+            std::string broken = encrypted;
+            broken[pos] = '#';
+            CHECK_THROW(cipher.transcript(broken), cipher_error);
+        }
+    }
+}
+
+SUITE(CacheTest) {
+    TEST(RepeatedLengthHits) {
+        code::permutations().clear();
+        code cipher(4, "PROGRAM");
+        CHECK_EQUAL("GORPRAM", cipher.encryption("PROGRAM"));
+        CHECK_EQUAL("GORPRAM", cipher.encryption("PROGRAM"));
+        CHECK_EQUAL("PROGRAM", cipher.transcript("GORPRAM", "PROGRAM"));
+        permutationCache::stats s = code::permutations().statistics();
+        CHECK_EQUAL(1u, s.misses);
+        CHECK_EQUAL(2u, s.hits);
+        CHECK_EQUAL(1u, s.entries);
+        CHECK_EQUAL(7 * sizeof(uint32_t), s.bytes);
+    }
+    TEST(DifferentGeometryMisses) {
+        code::permutations().clear();
+        code three(3, "HELLO");
+        code four(4, "HELLO");
+        three.encryption("HELLO");
+        four.encryption("HELLO");
+        three.encryption("HELLOWORLD");
+        CHECK_EQUAL(3u, code::permutations().statistics().misses);
+    }
+    TEST(RouteVariantsDoNotCollide) {
+        // Та же длина и число столбцов, но маршрут по всему тексту
+        code::permutations().clear();
+        code::permutations().getMap(4, 7, route::columnsRightToLeft::id, [](uint32_t* to) {
+            route::routeMap<route::columnsRightToLeft>(to, 7, 4);
+        });
+        code cipher(4, "PROGRAM");
+        CHECK_EQUAL("GORPRAM", cipher.encryption("PROGRAM"));
+        CHECK_EQUAL("PROGRAM", cipher.transcript("GORPRAM"));
+        CHECK_EQUAL(2u, code::permutations().statistics().entries);
+    }
+    TEST(CapacityEvictsOldest) {
+        code::permutations().clear();
+        code::permutations().setCapacity(100 * sizeof(uint32_t));
+        code cipher(3, "ABC");
+        cipher.encryption(std::string(60, 'a'));
+        cipher.encryption(std::string(30, 'b'));
+        cipher.encryption(std::string(50, 'c'));
+        permutationCache::stats s = code::permutations().statistics();
+        CHECK(s.bytes <= 100 * sizeof(uint32_t));
+        CHECK_EQUAL(2u, s.entries);
+        cipher.encryption(std::string(60, 'a'));
+        CHECK_EQUAL(4u, code::permutations().statistics().misses);
+        cipher.encryption(std::string(200, 'd'));
+        CHECK(code::permutations().statistics().bytes <= 100 * sizeof(uint32_t));
+        code::permutations().setCapacity(16 << 20);
+    }
+    TEST(ConcurrentUse) {
+        code::permutations().clear();
+        std::atomic<int> failures(0);
+        std::vector<std::thread> workers;
+        for (int w = 0; w < 8; w++)
+            workers.emplace_back([&, w] {
+                code cipher(2 + w % 3, "HELLO");
+                for (int n = 0; n < 300; n++) {
+                    std::string text(5 + n % 40, 'a' + n % 26);
+                    text[0] = 'Z';
+                    if (cipher.transcript(cipher.encryption(text), text) != text)
+                        failures++;
+                }
+            });
+        for (auto& w : workers)
+            w.join();
+        CHECK_EQUAL(0, failures.load());
+        permutationCache::stats s = code::permutations().statistics();
+        CHECK_EQUAL(8u * 300 * 2, s.hits + s.misses);
+    }
+}
+
+/// Перестановка строки по маршруту Route
+template <class Route>
+static std::string routeText(const std::string& text, size_t cols, bool inverse) {
+    std::string out(text.size(), '\0');
+    route::routeKernel<Route>::apply(text.data(), &out[0], text.size(), cols, inverse, [](char) { return true; });
+    return out;
+}
+
+/// Проверяет, что шифрование и расшифрование по маршруту Route взаимно обратны
+template <class Route>
+static bool routeRoundTrip(const std::string& text) {
+    for (size_t cols = 1; cols <= text.size(); cols++)
+        if (routeText<Route>(routeText<Route>(text, cols, false), cols, true) != text)
+            return false;
+    return true;
+}
+
+SUITE(RouteTest) {
+    TEST(CompileTimeTable) {
+        constexpr auto table = route::routeTable<route::spiral, 12, 4>();
+        static_assert(table[0] == 0 && table[7] == 4 && table[5] == 10, "spiral");
+        CHECK_EQUAL(9u, table[4]);
+    }
+    TEST(KnownRoutes) {
+        CHECK_EQUAL("DHLKGCBFJIEA", routeText<route::snake>("ABCDEFGHIJKL", 4, false));
+        CHECK_EQUAL("ABCDHLKJIEFG", routeText<route::spiral>("ABCDEFGHIJKL", 4, false));
+        CHECK_EQUAL("ABEIFCDGJKHL", routeText<route::zigzag>("ABCDEFGHIJKL", 4, false));
+        CHECK_EQUAL("DHLCGKBFJAEI", routeText<route::columnsRightToLeft>("ABCDEFGHIJKL", 4, false));
+        CHECK_EQUAL("LHDKGCJFBIEA", routeText<route::columnsBottomUp>("ABCDEFGHIJKL", 4, false));
+    }
+    TEST(PartialLastRowSkipped) {
+        CHECK_EQUAL("DHCGBFJAEI", routeText<route::columnsRightToLeft>("ABCDEFGHIJ", 4, false));
+        CHECK_EQUAL("ABCDHJIEFG", routeText<route::spiral>("ABCDEFGHIJ", 4, false));
+    }
+    TEST(RoundTrip) {
+        std::string text = "TheQuickBrownFoxJumpsOverTheLazyDog";
+        CHECK(routeRoundTrip<route::columnsRightToLeft>(text));
+        CHECK(routeRoundTrip<route::columnsBottomUp>(text));
+        CHECK(routeRoundTrip<route::snake>(text));
+        CHECK(routeRoundTrip<route::spiral>(text));
+        CHECK(routeRoundTrip<route::zigzag>(text));
+    }
+    TEST(SpecializedMatchesWalk) {
+        std::string text(100000, 'a');
+        for (size_t i = 0; i < text.size(); i++)
+            text[i] = 'a' + i * 7 % 26;
+        std::string walked(text.size(), '\0');
+        for (size_t n : {size_t(1000), size_t(99999)})
+            for (size_t cols : {2, 17, 64, 1000}) {
+                route::routeWalk<route::columnsBottomUp>(text.data(), &walked[0], n, cols, false, [](char) { return true; });
+                CHECK(routeText<route::columnsBottomUp>(text.substr(0, n), cols, false) == walked.substr(0, n));
+                route::routeWalk<route::columnsRightToLeft>(text.data(), &walked[0], n, cols, false, [](char) { return true; });
+                CHECK(routeText<route::columnsRightToLeft>(text.substr(0, n), cols, false) == walked.substr(0, n));
+            }
+    }
+}
+
+SUITE(ParallelTest) {
+    TEST(MatchesSingleThread) {
+        size_t saved = code::parallelThreshold;
+        code::parallelThreshold = 0;
+        std::string text(300007, 'a');
+        for (size_t i = 0; i < text.size(); i++)
+            text[i] = 'a' + i * 7 % 26;
+        for (int key : {2, 3, 64, 1000, 50000}) {
+            code cipher(key, text);
+            std::string encrypted = cipher.encryption(text);
+            for (unsigned threads : {1u, 2u, 3u, 8u}) {
+                CHECK(encrypted == cipher.encryption(text, threads));
+                CHECK(text == cipher.transcript(encrypted, threads));
+            }
+        }
+        code::parallelThreshold = saved;
+    }
+    TEST(WithSpacesAndErrors) {
+        size_t saved = code::parallelThreshold;
+        code::parallelThreshold = 0;
+        std::string text;
+        for (int i = 0; i < 20000; i++)
+            text += "Hello World ";
+        code cipher(7, text);
+        CHECK_EQUAL(cipher.encryption(text), cipher.encryption(text, 4));
+        std::string broken = text;
+        std::replace(broken.begin(), broken.end(), ' ', 'x');
+        broken[123456] = '1';
+        CHECK_THROW(cipher.encryption(broken, 4), cipher_error);
+        CHECK_THROW(cipher.transcript(broken, 4), cipher_error);
+        CHECK_THROW(cipher.transcript("", 4), cipher_error);
+        code::parallelThreshold = saved;
+    }
+    TEST(BelowThreshold) {
+        code cipher(3, "HELLO");
+        CHECK_EQUAL("LEHLO", cipher.encryption("HELLO", 8));
+        CHECK_EQUAL("HELLO", cipher.transcript("LEHLO", 8));
+    }
+}
+
+/**
+ * @brief Записывает текст во временный файл
+ */
+static void writeFile(const char* path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+/**
+ * @brief Читает файл целиком
+ */
+static std::string readFile(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+SUITE(FileTest) {
+    TEST(MatchesInMemory) {
+        std::string text;
+        for (int i = 0; i < 3001; i++)
+            text += char('A' + i % 26) + std::string(i % 7 == 0 ? "z" : "");
+        for (int key : {2, 3, 7, 64, 3000}) {
+            code cipher(key, text);
+            writeFile("route_in.tmp", text);
+            // Малый бюджет: много полос и несколько записей буфера
+            for (size_t memory : {size_t(2 * key), size_t(4 * key + 10), size_t(1 << 20)}) {
+                cipher.encryption_file("route_in.tmp", "route_out.tmp", memory);
+                CHECK_EQUAL(cipher.encryption(text), readFile("route_out.tmp"));
+                cipher.transcript_file("route_out.tmp", "route_back.tmp", memory);
+                CHECK_EQUAL(text, readFile("route_back.tmp"));
+            }
+        }
+        std::remove("route_in.tmp");
+        std::remove("route_out.tmp");
+        std::remove("route_back.tmp");
+    }
+    TEST(ShorterThanKey) {
+        // Ни одной полной строки: файл, как и строка в памяти, не меняется
+        code cipher(5, "HELLOWORLD");
+        writeFile("route_in.tmp", "ABC");
+        cipher.encryption_file("route_in.tmp", "route_out.tmp", 64);
+        CHECK_EQUAL(cipher.encryption("ABC"), readFile("route_out.tmp"));
+        CHECK_EQUAL("ABC", readFile("route_out.tmp"));
+        cipher.transcript_file("route_out.tmp", "route_back.tmp", 64);
+        CHECK_EQUAL("ABC", readFile("route_back.tmp"));
+        CHECK(!std::ifstream("route_out.tmp.spill"));
+        std::remove("route_in.tmp");
+        std::remove("route_out.tmp");
+        std::remove("route_back.tmp");
+    }
+    TEST(Errors) {
+        code cipher(3, "HELLO");
+        CHECK_THROW(cipher.encryption_file("route_missing.tmp", "route_out.tmp", 64), cipher_error);
+        writeFile("route_in.tmp", "");
+        CHECK_THROW(cipher.encryption_file("route_in.tmp", "route_out.tmp", 64), cipher_error);
+        writeFile("route_in.tmp", "HELLO");
+        CHECK_THROW(cipher.encryption_file("route_in.tmp", "route_out.tmp", 5), cipher_error);
+        writeFile("route_in.tmp", "HELLO WORLD");
+        CHECK_THROW(cipher.encryption_file("route_in.tmp", "route_out.tmp", 8), cipher_error);
+        CHECK(!std::ifstream("route_out.tmp"));
+        CHECK(!std::ifstream("route_out.tmp.spill"));
+        writeFile("route_in.tmp", "HELLOWORLD1");
+        CHECK_THROW(cipher.transcript_file("route_in.tmp", "route_out.tmp", 8), cipher_error);
+        CHECK(!std::ifstream("route_out.tmp"));
+        std::remove("route_in.tmp");
+    }
+}
+
+/**
+ * @brief Текст в 1 МБ, уже прошедший проверку: только латинские буквы без пробелов
+ */
+static string validMegabyte() {
+    string text(1u << 20, 'a');
+    for (size_t i = 0; i < text.size(); i++)
+        text[i] = 'a' + i * 7 % 26;
+    return text;
+}
+
+/// Бюджеты выделений памяти в установившемся режиме (второй и последующие вызовы)
+SUITE(AllocationBudgetTest) {
+    TEST_FIXTURE(allocationFixture, EncryptionTwoStrings) {
+        string text = validMegabyte();
+        code cipher(64, text);
+        string encrypted = cipher.encryption(text);
+        allocations.restart();
+        encrypted = cipher.encryption(text);
+        // Текст без пробелов и результат
+        CHECK(allocations.allocations() <= 2);
+        CHECK(allocations.bytes() <= 2 * (text.size() + 1));
+    }
+
+    TEST_FIXTURE(allocationFixture, TranscriptOneResult) {
+        string text = validMegabyte();
+        code cipher(64, text);
+        string encrypted = cipher.encryption(text);
+        cipher.transcript(encrypted);
+        allocations.restart();
+        cipher.transcript(encrypted);
+        CHECK(allocations.allocations() <= 1);
+        allocations.restart();
+        cipher.transcript(encrypted, text);
+        CHECK(allocations.allocations() <= 1);
+        CHECK(allocations.bytes() <= text.size() + 1);
+    }
+
+    TEST_FIXTURE(allocationFixture, IntoNoneInPlaceBitmap) {
+        string text = validMegabyte();
+        code cipher(64, text);
+        string out(text.size(), ' ');
+        allocations.restart();
+        cipher.encryption_into(text, &out[0], out.size());
+        cipher.transcript_into(out, &text[0], text.size());
+        CHECK_EQUAL(size_t(0), allocations.allocations());
+        allocations.restart();
+        cipher.encryption_in_place(&text[0], text.size());
+        CHECK(allocations.allocations() <= 1);
+        CHECK(allocations.bytes() <= text.size() / 8);
+    }
+
+    TEST_FIXTURE(allocationFixture, CachedShortMessages) {
+        string text = validMegabyte().substr(0, 4096);
+        code cipher(64, text);
+        string encrypted = cipher.encryption(text);
+        cipher.transcript(encrypted);
+        allocations.restart();
+        for (int i = 0; i < 100; i++)
+            cipher.transcript(cipher.encryption(text));
+        // Перестановка берётся из кэша, выделяются только строки
+        CHECK(allocations.allocations() <= 100 * 3);
+    }
+
+    TEST_FIXTURE(allocationFixture, ParallelPerThread) {
+        string text = validMegabyte();
+        code cipher(64, text);
+        size_t saved = code::parallelThreshold;
+        code::parallelThreshold = 0;
+        string encrypted = cipher.encryption(text, 4);
+        allocations.restart();
+        encrypted = cipher.encryption(text, 4);
+        cipher.transcript(encrypted, 4);
+        code::parallelThreshold = saved;
+        // Два результата и служебные данные потоков
+        CHECK(allocations.allocations() <= 2 + 2 * 4 * 4);
+        CHECK(allocations.bytes() <= 2 * (text.size() + 4096));
+    }
+}
+
+SUITE(StatsTest) {
+    TEST(StagesCounted) {
+        code cipher(4, "HELLO WORLD");
+        cipherStats::snapshot before = cipherStats::take();
+        string encrypted = cipher.encryption("HELLO WORLD");
+        cipher.transcript(encrypted);
+        cipherStats::snapshot d = cipherStats::difference(cipherStats::take(), before);
+#ifdef CIPHER_STATS
+        CHECK(d.enabled);
+        CHECK_EQUAL(uint64_t(11), d.stages[cipherStats::validate].bytes);
+        CHECK_EQUAL(uint64_t(10 + 10), d.stages[cipherStats::transform].bytes);
+        CHECK_EQUAL(uint64_t(0), d.stages[cipherStats::decode].calls);
+        CHECK(d.allocations >= 3);
+#else
+        CHECK(!d.enabled);
+        CHECK_EQUAL(uint64_t(0), d.stages[cipherStats::transform].bytes);
+        CHECK_EQUAL(uint64_t(0), d.allocations);
+#endif
+    }
+}
+
 /**
  * @brief Главная функция запуска тестов
  * @param argc Количество аргументов
@@ -7,6 +7,12 @@
  */
 
 #include "route.h"
+#include "../../cipherlib/cipherStats.h"
+#include "../../cipherlib/routePolicy.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <numeric>
 
 /**
  * @brief Конструктор класса code
@@ -18,43 +24,119 @@ code::code(int skey, string text) {
     key = getValidKey(skey, text);
 }
 
+/**
+ * @brief Вычисляет позицию символа в зашифрованном тексте
+ * @details Символ k открытого текста стоит в строке k / key и столбце k % key таблицы
+ *          из rows полных строк; столбцы читаются справа налево. Символы за последней
+ *          полной строкой остаются на своих местах.
+ * @param k Позиция в открытом тексте
+ * @param rows Количество полных строк таблицы
+ * @param key Количество столбцов
+ * @return Позиция в зашифрованном тексте
+ */
+static inline size_t routeIndex(size_t k, size_t rows, size_t key) {
+    if (k >= rows * key)
+        return k;
+    return (key - 1 - k % key) * rows + k / key;
+}
+
+/// Маршрут чтения таблицы
+using routeOrder = route::columnsRightToLeft;
+
+permutationCache& code::permutations() {
+    static permutationCache cache(16 << 20);
+    return cache;
+}
+
+/// Латинская буква (то же, что isalpha в локали "C")
+static inline bool isLatin(char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+}
+
+/// Предикат для уже проверенного текста
+static inline bool anyChar(char) {
+    return true;
+}
+
+/**
+ * @brief Переставляет символы по маршруту таблицы без построения самой таблицы
+ * @details Символ из строки i и столбца j таблицы из rows = n / key полных строк
+ *          попадает в позицию (key - 1 - j) * rows + i, то есть перестановка - это
+ *          транспонирование с обратным порядком столбцов. Символы за последней полной
+ *          строкой (n % key штук) в таблицу не входят и остаются на своих местах.
+ *          Короткие тексты переставляются по перестановке из кэша, длинные - ядром
+ *          маршрута routeOrder. Записанные символы проверяются предикатом в том же проходе.
+ * @param in Исходный текст
+ * @param out Результат (n байт, не пересекается с in)
+ * @param n Длина текста
+ * @param key Количество столбцов
+ * @param inverse true - обратная перестановка (расшифрование)
+ * @param cached Разрешено обращаться к кэшу (может выделять память)
+ * @param valid Предикат допустимого символа
+ * @return true, если все символы допустимы (иначе содержимое out не определено)
+ */
+template <class F>
+static bool routeCopy(const char* in, char* out, size_t n, size_t key, bool inverse, bool cached, F valid) {
+    size_t rows = n / key;
+    bool ok = true;
+    if (cached && n <= code::cachedLength) {
+        permutationCache::map m = code::permutations().getMap(key, n, route::fullRowsId<routeOrder>, [&](uint32_t* to) {
+            cipherStats::allocation(n * sizeof(uint32_t));
+            route::routeMap<routeOrder>(to, rows * key, key);
+            iota(to + rows * key, to + n, uint32_t(rows * key));
+        });
+        const uint32_t* to = m->data();
+        for (size_t k = 0; k < n; k++) {
+            if (inverse)
+                out[k] = in[to[k]];
+            else
+                out[to[k]] = in[k];
+            ok &= valid(in[k]);
+        }
+        return ok;
+    }
+    ok = route::routeKernel<routeOrder>::apply(in, out, rows * key, key, inverse, valid);
+    for (size_t k = rows * key; k < n; k++) {
+        out[k] = in[k];
+        ok &= valid(in[k]);
+    }
+    return ok;
+}
+
+size_t code::parallelThreshold = 4 << 20;
+
+/**
+ * @brief Перестановка по маршруту в несколько потоков (без кэша)
+ * @param threads Количество потоков; 1 - в вызывающем потоке
+ * @see routeCopy - остальные параметры
+ */
+template <class F>
+static bool routeCopyParallel(const char* in, char* out, size_t n, size_t key, bool inverse, unsigned threads,
+                              F valid) {
+    size_t rows = n / key;
+    bool ok = route::routeParallel<routeOrder>(in, out, rows * key, key, inverse, valid, threads);
+    for (size_t k = rows * key; k < n; k++) {
+        out[k] = in[k];
+        ok &= valid(in[k]);
+    }
+    return ok;
+}
+
 /**
  * @brief Шифрование текста методом табличной маршрутной перестановки
  * @param text Открытый текст
  * @return Зашифрованная строка
  */
 string code::encryption(const string& text) {
+    cipherStats::stageClock clock;
     string t = getValidOpenText(text);
-    int k = 0;
-    int simvoli = t.size();
-    int stroki = simvoli / key;
-    char** tabl = new char* [stroki];
-    for (int i = 0; i < stroki; i++)
-        tabl[i] = new char [key];
-
-    // Запись по строкам слева направо
-    for (int i = 0; i < stroki; i++)
-        for (int j = 0; j < key; j++) {
-            if(k < simvoli) {
-                tabl[i][j] = t[k];
-                k++;
-            }
-        }
-
-    // Чтение по столбцам справа налево
-    k = 0;
-    for (int j = key - 1; j >= 0 ; j--)
-        for (int i = 0; i < stroki; i++) {
-            t[k] = tabl[i][j];
-            k++;
-        }
-
-    // Очистка памяти
-    for (int i = 0; i < stroki; i++)
-        delete[] tabl[i];
-    delete[] tabl;
-
-    return t;
+    cipherStats::allocation(text.size());
+    clock.charge(cipherStats::validate, text.size());
+    string result(t.size(), '\0');
+    cipherStats::allocation(t.size());
+    routeCopy(t.data(), &result[0], t.size(), key, false, true, anyChar);
+    clock.charge(cipherStats::transform, t.size());
+    return result;
 }
 
 /**
@@ -64,14 +146,14 @@ string code::encryption(const string& text) {
  * @return Расшифрованная строка
  */
 string code::transcript(const string& text, const string& open_text) {
+    cipherStats::stageClock clock;
     if (text.empty() || open_text.empty()) {
         throw cipher_error("Один из текстов пуст!");
     }
 
-    for (char c : text) {
-        if (!isalpha(c)) {
-            throw cipher_error("Некорректные символы в зашифрованном тексте!");
-        }
+    // Прежний порядок ошибок: сначала символы шифртекста, затем открытого текста, затем длина
+    if (!all_of(text.begin(), text.end(), isLatin)) {
+        throw cipher_error("Некорректные символы в зашифрованном тексте!");
     }
 
     for (char c : open_text) {
@@ -79,36 +161,349 @@ string code::transcript(const string& text, const string& open_text) {
             throw cipher_error("Некорректные символы в открытом тексте!");
         }
     }
+    getValidCipherText(text, open_text);
+    clock.charge(cipherStats::validate, text.size() + open_text.size());
 
-    string t = getValidCipherText(text, open_text);
-    int k = 0;
-    int simvoli = t.size();
-    int stroki = simvoli / key;
-    char** tabl = new char* [stroki];
-    for (int i = 0; i < stroki; i++)
-        tabl[i] = new char [key];
+    // Шифртекст уже проверен, поэтому перестановка его повторно не проверяет
+    string result(text.size(), '\0');
+    cipherStats::allocation(text.size());
+    routeCopy(text.data(), &result[0], text.size(), key, true, true, anyChar);
+    clock.charge(cipherStats::transform, text.size());
+    return result;
+}
+
+/**
+ * @brief Расшифрование текста по ключу
+ * @param text Зашифрованный текст
+ * @return Расшифрованная строка
+ */
+string code::transcript(const string& text) {
+    if (text.empty()) {
+        throw cipher_error("Отсутствует зашифрованный текст!");
+    }
+    cipherStats::stageClock clock;
+    string result(text.size(), '\0');
+    cipherStats::allocation(text.size());
+    if (!routeCopy(text.data(), &result[0], text.size(), key, true, true, isLatin)) {
+        throw cipher_error("Некорректные символы в зашифрованном тексте!");
+    }
+    clock.charge(cipherStats::transform, text.size());
+    return result;
+}
 
-    // Заполнение таблицы из зашифрованного текста (обратный порядок чтения)
-    for (int j = key - 1; j >= 0 ; j--)
-        for (int i = 0; i < stroki; i++) {
-            tabl[i][j] = t[k];
-            k++;
+/**
+ * @brief Многопоточное шифрование текста
+ * @param text Открытый текст
+ * @param threads Количество потоков
+ * @return Зашифрованная строка
+ */
+string code::encryption(const string& text, unsigned threads) {
+    if (text.size() < parallelThreshold) {
+        threads = 1;
+    }
+    cipherStats::stageClock clock;
+    // Текст без пробелов переставляется сразу, символы проверяются в полосах
+    if (!text.empty() && text.find(' ') == string::npos) {
+        clock.charge(cipherStats::validate, text.size());
+        string result(text.size(), '\0');
+        cipherStats::allocation(text.size());
+        if (!routeCopyParallel(text.data(), &result[0], text.size(), key, false, threads, isLatin)) {
+            throw cipher_error("В тексте встречены некорректные символы!");
         }
+        clock.charge(cipherStats::transform, text.size());
+        return result;
+    }
+    string t = getValidOpenText(text);
+    cipherStats::allocation(text.size());
+    clock.charge(cipherStats::validate, text.size());
+    string result(t.size(), '\0');
+    cipherStats::allocation(t.size());
+    routeCopyParallel(t.data(), &result[0], t.size(), key, false, threads, anyChar);
+    clock.charge(cipherStats::transform, t.size());
+    return result;
+}
 
-    // Чтение таблицы по строкам слева направо
-    k = 0;
-    for (int i = 0; i < stroki; i++)
-        for (int j = 0; j < key; j++) {
-            t[k] = tabl[i][j];
-            k++;
+/**
+ * @brief Многопоточное расшифрование текста по ключу
+ * @param text Зашифрованный текст
+ * @param threads Количество потоков
+ * @return Расшифрованная строка
+ */
+string code::transcript(const string& text, unsigned threads) {
+    if (text.empty()) {
+        throw cipher_error("Отсутствует зашифрованный текст!");
+    }
+    if (text.size() < parallelThreshold) {
+        threads = 1;
+    }
+    cipherStats::stageClock clock;
+    string result(text.size(), '\0');
+    cipherStats::allocation(text.size());
+    if (!routeCopyParallel(text.data(), &result[0], text.size(), key, true, threads, isLatin)) {
+        throw cipher_error("Некорректные символы в зашифрованном тексте!");
+    }
+    clock.charge(cipherStats::transform, text.size());
+    return result;
+}
+
+/**
+ * @brief Временный файл внешнего режима, удаляемый при выходе из области видимости
+ * @details Таблица открытого текста хранится в нём полосами по band строк: отрезок
+ *          столбца j полосы из h строк с началом r0 лежит со смещения r0 * key + j * h.
+ */
+struct spillFile {
+    string path;
+    fstream file;
+    explicit spillFile(const string& p) : path(p), file(p, ios::in | ios::out | ios::binary | ios::trunc) {
+        if (!file) {
+            throw cipher_error("Не удалось создать временный файл: " + path);
+        }
+    }
+    ~spillFile() {
+        file.close();
+        std::remove(path.c_str());
+    }
+    void read(size_t offset, char* data, size_t size) {
+        file.seekg(streamoff(offset));
+        if (!file.read(data, size)) {
+            throw cipher_error("Ошибка чтения временного файла: " + path);
+        }
+    }
+    void write(size_t offset, const char* data, size_t size) {
+        file.seekp(streamoff(offset));
+        if (!file.write(data, size)) {
+            throw cipher_error("Ошибка записи временного файла: " + path);
+        }
+    }
+};
+
+/**
+ * @brief Общая часть encryption_file/transcript_file
+ * @details Первый проход последовательно читает вход и раскладывает таблицу по
+ *          временному файлу: при шифровании полоса строк транспонируется в памяти и
+ *          дописывается целиком, при расшифровании столбцы шифртекста читаются подряд
+ *          и разносятся по отрезкам полос. Второй проход последовательно пишет выход:
+ *          при шифровании столбцы собираются из отрезков всех полос, при расшифровании
+ *          каждая полоса читается целиком и транспонируется обратно в строки.
+ *          Отрезки занимают band = memory / 2 / key байт, в памяти одновременно
+ *          держатся два буфера по band * key байт. Выходной файл создаётся после
+ *          проверки всех символов первым проходом.
+ * @param inverse true - расшифрование
+ */
+static void routeFile(const string& input, const string& output, size_t key, size_t memory, bool inverse) {
+    ifstream in(input, ios::binary);
+    if (!in) {
+        throw cipher_error("Не удалось открыть файл: " + input);
+    }
+    in.seekg(0, ios::end);
+    size_t n = size_t(in.tellg());
+    in.seekg(0);
+    if (n == 0) {
+        throw cipher_error(inverse ? "Отсутствует зашифрованный текст!" : "Отсутствует открытый текст!");
+    }
+    if (memory < 2 * key) {
+        throw cipher_error("Недостаточно памяти для ключа");
+    }
+
+    size_t rows = n / key;
+    size_t band = min(rows, memory / 2 / key);
+    vector<char> buffer(band * key);
+    vector<char> columns(band * key);
+    unique_ptr<spillFile> spill;
+    bool ok = true;
+
+    if (rows > 0) {
+        spill.reset(new spillFile(output + ".spill"));
+        if (!inverse) {
+            for (size_t r0 = 0; r0 < rows; r0 += band) {
+                size_t h = min(band, rows - r0);
+                if (!in.read(buffer.data(), h * key)) {
+                    throw cipher_error("Ошибка чтения файла: " + input);
+                }
+                ok &= transposeBytes(buffer.data(), key, 1, columns.data(), h, 1, h, key, isLatin);
+                spill->write(r0 * key, columns.data(), h * key);
+            }
+        } else {
+            // Столбцы шифртекста идут справа налево, каждый - rows символов подряд.
+            // Если в буфер входит несколько столбцов, они читаются и разносятся
+            // группой: их отрезки в полосе соседние
+            size_t group = max<size_t>(1, buffer.size() / rows);
+            for (size_t o0 = 0; o0 < key; o0 += group) {
+                size_t g = min(group, key - o0);
+                size_t j0 = key - o0 - g;
+                if (rows <= buffer.size()) {
+                    if (!in.read(buffer.data(), g * rows)) {
+                        throw cipher_error("Ошибка чтения файла: " + input);
+                    }
+                    ok &= all_of(buffer.begin(), buffer.begin() + g * rows, isLatin);
+                }
+                for (size_t r0 = 0; r0 < rows; r0 += band) {
+                    size_t h = min(band, rows - r0);
+                    if (rows > buffer.size()) {
+                        if (!in.read(columns.data(), h)) {
+                            throw cipher_error("Ошибка чтения файла: " + input);
+                        }
+                        ok &= all_of(columns.begin(), columns.begin() + h, isLatin);
+                    } else {
+                        for (size_t k = 0; k < g; k++)
+                            copy_n(buffer.data() + (g - 1 - k) * rows + r0, h, columns.data() + k * h);
+                    }
+                    spill->write(r0 * key + j0 * h, columns.data(), g * h);
+                }
+            }
         }
+    }
+    // Символы за последней полной строкой остаются на своих местах
+    string tail(n - rows * key, '\0');
+    in.read(&tail[0], tail.size());
+    ok &= all_of(tail.begin(), tail.end(), isLatin);
+    if (!ok) {
+        throw cipher_error(inverse ? "Некорректные символы в зашифрованном тексте!" :
+                                     "В тексте встречены некорректные символы!");
+    }
+
+    ofstream out(output, ios::binary | ios::trunc);
+    if (!out) {
+        throw cipher_error("Не удалось открыть файл: " + output);
+    }
+    try {
+        if (rows > 0) {
+            if (!inverse) {
+                // Столбец длиннее буфера пишется по отрезкам, короткие собираются группами
+                size_t group = max<size_t>(1, buffer.size() / rows);
+                for (size_t o0 = 0; o0 < key; o0 += group) {
+                    size_t g = min(group, key - o0);
+                    size_t j0 = key - o0 - g;
+                    for (size_t r0 = 0; r0 < rows; r0 += band) {
+                        size_t h = min(band, rows - r0);
+                        spill->read(r0 * key + j0 * h, columns.data(), g * h);
+                        if (rows > buffer.size()) {
+                            out.write(columns.data(), h);
+                        } else {
+                            for (size_t k = 0; k < g; k++)
+                                copy_n(columns.data() + k * h, h, buffer.data() + (g - 1 - k) * rows + r0);
+                        }
+                    }
+                    if (rows <= buffer.size()) {
+                        out.write(buffer.data(), g * rows);
+                    }
+                }
+            } else {
+                for (size_t r0 = 0; r0 < rows; r0 += band) {
+                    size_t h = min(band, rows - r0);
+                    spill->read(r0 * key, columns.data(), h * key);
+                    transposeBytes(columns.data(), h, 1, buffer.data(), key, 1, key, h);
+                    out.write(buffer.data(), h * key);
+                }
+            }
+        }
+        out.write(tail.data(), tail.size());
+        if (!out.flush()) {
+            throw cipher_error("Ошибка записи файла: " + output);
+        }
+    } catch (...) {
+        out.close();
+        std::remove(output.c_str());
+        throw;
+    }
+}
+
+void code::encryption_file(const string& input, const string& output, size_t memory) const {
+    routeFile(input, output, key, memory, false);
+}
 
-    // Очистка памяти
-    for (int i = 0; i < stroki; i++)
-        delete[] tabl[i];
-    delete[] tabl;
+void code::transcript_file(const string& input, const string& output, size_t memory) const {
+    routeFile(input, output, key, memory, true);
+}
+
+cipher_result code::encryption_into(string_view text, char* out, size_t out_size) const noexcept {
+    if (text.empty())
+        return {0, cipher_status::no_text};
+    cipherStats::stageClock clock;
+    size_t length = 0;
+    for (char c : text) {
+        if ((c < 'A' || c > 'Z') && (c < 'a' || c > 'z') && c != ' ')
+            return {0, cipher_status::invalid_text};
+        length += c != ' ';
+    }
+    clock.charge(cipherStats::validate, text.size());
+    if (length > out_size)
+        return {0, cipher_status::small_buffer};
+    if (length == text.size()) {
+        routeCopy(text.data(), out, length, key, false, false, anyChar);
+        clock.charge(cipherStats::transform, length);
+        return {length, cipher_status::ok};
+    }
+    size_t rows = length / key;
+    size_t k = 0;
+    for (char c : text)
+        if (c != ' ')
+            out[routeIndex(k++, rows, key)] = c;
+    clock.charge(cipherStats::transform, length);
+    return {length, cipher_status::ok};
+}
+
+cipher_result code::transcript_into(string_view text, string_view open_text, char* out, size_t out_size) const noexcept {
+    if (text.empty() || open_text.empty())
+        return {0, cipher_status::no_text};
+    cipherStats::stageClock clock;
+    for (char c : open_text)
+        if (!isalpha(static_cast<unsigned char>(c)))
+            return {0, cipher_status::invalid_text};
+    if (text.size() != open_text.size())
+        return {0, all_of(text.begin(), text.end(), isLatin) ? cipher_status::bad_length : cipher_status::invalid_text};
+    clock.charge(cipherStats::validate, open_text.size());
+    return transcript_into(text, out, out_size);
+}
+
+cipher_result code::transcript_into(string_view text, char* out, size_t out_size) const noexcept {
+    if (text.empty())
+        return {0, cipher_status::no_text};
+    if (text.size() > out_size)
+        return {0, cipher_status::small_buffer};
+    cipherStats::stageClock clock;
+    if (!routeCopy(text.data(), out, text.size(), key, true, false, isLatin))
+        return {0, cipher_status::invalid_text};
+    clock.charge(cipherStats::transform, text.size());
+    return {text.size(), cipher_status::ok};
+}
+
+cipher_result code::encryption_in_place(char* text, size_t n) const {
+    if (n == 0)
+        return {0, cipher_status::no_text};
+    cipherStats::stageClock clock;
+    for (size_t k = 0; k < n; k++) {
+        char c = text[k];
+        if ((c < 'A' || c > 'Z') && (c < 'a' || c > 'z') && c != ' ')
+            return {0, cipher_status::invalid_text};
+    }
+    size_t length = remove(text, text + n, ' ') - text;
+    clock.charge(cipherStats::validate, n);
+    size_t rows = length / key;
+    cipherStats::allocation((length + 63) / 64 * 8);
+    permuteInPlace(text, length, [&](size_t k) { return routeIndex(k, rows, key); }, false);
+    clock.charge(cipherStats::transform, length);
+    return {length, cipher_status::ok};
+}
 
-    return t;
+cipher_result code::transcript_in_place(char* text, size_t n, string_view open_text) const {
+    if (n == 0 || open_text.empty())
+        return {0, cipher_status::no_text};
+    cipherStats::stageClock clock;
+    for (size_t k = 0; k < n; k++)
+        if (!isalpha(static_cast<unsigned char>(text[k])))
+            return {0, cipher_status::invalid_text};
+    for (char c : open_text)
+        if (!isalpha(static_cast<unsigned char>(c)))
+            return {0, cipher_status::invalid_text};
+    if (n != open_text.size())
+        return {0, cipher_status::bad_length};
+    clock.charge(cipherStats::validate, n + open_text.size());
+    size_t rows = n / key;
+    cipherStats::allocation((n + 63) / 64 * 8);
+    permuteInPlace(text, n, [&](size_t k) { return routeIndex(k, rows, key); }, true);
+    clock.charge(cipherStats::transform, n);
+    return {n, cipher_status::ok};
 }
 
 /**
@@ -118,7 +513,7 @@ string code::transcript(const string& text, const string& open_text) {
  * @return Зашифрованный текст
  * @throw cipher_error Если длины не совпадают
  */
-inline string code::getValidCipherText(const string& s, const string& open_text) {
+inline const string& code::getValidCipherText(const string& s, const string& open_text) {
     int r1 = s.size();
     int r2 = open_text.size();
     if (r1 != r2) {
@@ -158,7 +553,7 @@ inline string code::getValidOpenText(const string& s) {
  * @throw cipher_error Если ключ меньше 2 или больше длины текста
  */
 inline int code::getValidKey(int key, const string& Text) {
-    if (key < 2 || key > Text.length()) {
+    if (key < 2 || size_t(key) > Text.length()) {
         throw cipher_error("Ключ некорректного размера");
     }
     return key;
@@ -8,8 +8,10 @@
  */
 
 #pragma once
+#include "../../cipherlib/permutationCache.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <algorithm>
 using namespace std;
@@ -27,12 +29,35 @@ public:
         invalid_argument(what_arg) {}
 };
 
+/**
+ * @enum cipher_status
+ * @brief Код результата операций, не выбрасывающих исключений
+ */
+enum class cipher_status {
+    ok,           ///< Успешно
+    no_text,      ///< Текст пуст
+    invalid_text, ///< Текст содержит некорректные символы
+    bad_length,   ///< Длины зашифрованного и открытого текстов не совпадают
+    small_buffer  ///< Буфер результата слишком мал
+};
+
+/**
+ * @struct cipher_result
+ * @brief Результат записи в буфер вызывающей стороны
+ */
+struct cipher_result {
+    size_t size; ///< Количество записанных байт (0 при ошибке)
+    cipher_status status; ///< Код результата
+};
+
 /**
  * @class code
  * @brief Класс для шифрования и расшифрования методом табличной маршрутной перестановки
  * @details Использует таблицу с заданным количеством столбцов (ключ). 
  *          Запись: по строкам слева направо, сверху вниз.
  *          Чтение: по столбцам сверху вниз, справа налево.
+ *          Таблица содержит только полные строки; последние length % key символов
+ *          в перестановке не участвуют и остаются в конце текста.
  */
 class code {
 private:
@@ -62,7 +87,7 @@ private:
      * @return Зашифрованный текст без изменений
      * @throw cipher_error Если длины текстов не совпадают
      */
-    inline string getValidCipherText(const string& s, const string& open_text);
+    inline const string& getValidCipherText(const string& s, const string& open_text);
 
 public:
     code() = delete; ///< Запрет конструктора без параметров
@@ -91,4 +116,132 @@ public:
      * @throw cipher_error Если тексты пустые, содержат некорректные символы или разной длины
      */
     string transcript(const string& text, const string& open_text);
+
+    /**
+     * @brief Расшифровывает текст, зная только ключ
+     * @details Размеры таблицы выводятся из длины зашифрованного текста; символы
+     *          проверяются в том же проходе, что и перестановка.
+     * @param text Зашифрованный текст
+     * @return Расшифрованная строка
+     * @throw cipher_error Если текст пустой или содержит некорректные символы
+     */
+    string transcript(const string& text);
+
+    /**
+     * @brief Шифрует текст в несколько потоков
+     * @details Таблица делится на полосы строк, потоки разбирают их из общей очереди
+     *          и пишут в непересекающиеся части результата. Тексты короче
+     *          parallelThreshold шифруются в вызывающем потоке. Результат совпадает
+     *          с encryption(text).
+     * @param text Текст для шифрования
+     * @param threads Количество потоков (0 - по числу ядер)
+     * @return Зашифрованная строка
+     * @throw cipher_error Если текст пустой или содержит некорректные символы
+     */
+    string encryption(const string& text, unsigned threads);
+
+    /**
+     * @brief Расшифровывает текст по ключу в несколько потоков
+     * @details Результат совпадает с transcript(text).
+     * @param text Зашифрованный текст
+     * @param threads Количество потоков (0 - по числу ядер)
+     * @return Расшифрованная строка
+     * @throw cipher_error Если текст пустой или содержит некорректные символы
+     */
+    string transcript(const string& text, unsigned threads);
+
+    /**
+     * @brief Шифрует файл, который может не помещаться в память
+     * @details Файл читается полосами строк таблицы; каждая полоса транспонируется в
+     *          памяти и дописывается во временный файл output + ".spill" отрезками
+     *          столбцов. Затем отрезки собираются по столбцам в выходной файл.
+     *          Чтение и запись последовательны, блоками до memory / 2 байт.
+     *          На диске нужно место под временный файл размером с входной.
+     *          Файл должен содержать только латинские буквы; результат совпадает
+     *          с encryption() для его содержимого.
+     * @param input Путь к открытому тексту
+     * @param output Путь к результату (создаётся только при корректном входе)
+     * @param memory Ограничение памяти в байтах (не меньше 2 * ключ)
+     * @throw cipher_error Если файлы не открываются, текст пуст или некорректен,
+     *        либо memory слишком мал для ключа
+     */
+    void encryption_file(const string& input, const string& output, size_t memory) const;
+
+    /**
+     * @brief Расшифровывает файл, который может не помещаться в память
+     * @details Обратная перестановка тем же способом; результат совпадает с transcript().
+     * @param input Путь к зашифрованному тексту
+     * @param output Путь к результату
+     * @param memory Ограничение памяти в байтах
+     * @throw cipher_error Если файлы не открываются, текст пуст или некорректен,
+     *        либо memory слишком мал
+     */
+    void transcript_file(const string& input, const string& output, size_t memory) const;
+
+    /**
+     * @brief Шифрует текст в буфер вызывающей стороны без выделения памяти
+     * @details Пробелы удаляются, поэтому буфера размером text.size() всегда достаточно.
+     *          Исключения не выбрасываются.
+     * @param text Текст для шифрования
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result encryption_into(string_view text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Расшифровывает текст в буфер вызывающей стороны без выделения памяти
+     * @details Исключения не выбрасываются.
+     * @param text Зашифрованный текст
+     * @param open_text Исходный открытый текст (для проверки длины)
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result transcript_into(string_view text, string_view open_text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Расшифровывает текст по ключу в буфер вызывающей стороны без выделения памяти
+     * @details Символы проверяются в том же проходе, что и перестановка.
+     *          Исключения не выбрасываются.
+     * @param text Зашифрованный текст
+     * @param out Буфер результата
+     * @param out_size Размер буфера
+     * @return Количество записанных байт и код результата
+     */
+    cipher_result transcript_into(string_view text, char* out, size_t out_size) const noexcept;
+
+    /**
+     * @brief Шифрует текст на месте
+     * @details Пробелы удаляются сдвигом внутри буфера, затем символы переставляются
+     *          по циклам перестановки. Дополнительная память - n / 8 байт.
+     * @param text Текст; при успехе первые size байт содержат результат
+     * @param n Длина текста
+     * @return Длина результата и код результата (при ошибке текст не изменяется)
+     * @throw std::bad_alloc Если не удалось выделить битовый массив
+     */
+    cipher_result encryption_in_place(char* text, size_t n) const;
+
+    /**
+     * @brief Расшифровывает текст на месте
+     * @details Дополнительная память - n / 8 байт.
+     * @param text Зашифрованный текст, заменяется расшифрованным
+     * @param n Длина текста
+     * @param open_text Исходный открытый текст (для проверки длины)
+     * @return Длина результата и код результата (при ошибке текст не изменяется)
+     * @throw std::bad_alloc Если не удалось выделить битовый массив
+     */
+    cipher_result transcript_in_place(char* text, size_t n, string_view open_text) const;
+
+    /**
+     * @brief Общий кэш перестановок, используемый encryption() и transcript()
+     * @details Тексты до cachedLength символов переставляются одним проходом по
+     *          перестановке из кэша, более длинные - блочным транспонированием.
+     *          Ёмкость по умолчанию - 16 МБ, её можно изменить через setCapacity().
+     * @return Кэш перестановок
+     */
+    static permutationCache& permutations();
+
+    static const size_t cachedLength = 64 * 1024; ///< Наибольшая длина текста, перестановка которого кэшируется
+    static size_t parallelThreshold; ///< Наименьшая длина текста, переставляемого в несколько потоков
 };
\ No newline at end of file
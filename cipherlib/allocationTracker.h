@@ -0,0 +1,99 @@
+/**
+ * @file allocationTracker.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-21
+ * @brief Подсчёт выделений памяти в тестах UnitTest++
+ * @details Заменяет глобальные operator new/delete программы счётчиками вызовов и байт,
+ *          поэтому подключается ровно в одном файле тестов. allocationScope запоминает
+ *          счётчики при создании и возвращает, сколько выделений произошло с тех пор;
+ *          allocationFixture - то же для TEST_FIXTURE. Счётчики общие для всех потоков.
+ *          Выровненные формы operator new (align_val_t) не заменяются и не считаются.
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace allocationTracker {
+
+inline std::atomic<size_t> calls(0); ///< Вызовы operator new и new[]
+inline std::atomic<size_t> bytes(0); ///< Запрошено байт
+
+/// Выделение памяти со счётом; nullptr при нехватке памяти
+inline void* allocate(std::size_t size) noexcept {
+    calls.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+/// Освобождение памяти, выделенной allocate(). Не встраивается: иначе GCC видит
+/// free() для указателя из operator new и выдаёт -Wmismatched-new-delete
+[[gnu::noinline]] inline void release(void* p) noexcept {
+    std::free(p);
+}
+
+} // namespace allocationTracker
+
+void* operator new(std::size_t size) {
+    if (void* p = allocationTracker::allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = allocationTracker::allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocationTracker::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocationTracker::allocate(size); }
+void operator delete(void* p) noexcept { allocationTracker::release(p); }
+void operator delete[](void* p) noexcept { allocationTracker::release(p); }
+void operator delete(void* p, std::size_t) noexcept { allocationTracker::release(p); }
+void operator delete[](void* p, std::size_t) noexcept { allocationTracker::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { allocationTracker::release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { allocationTracker::release(p); }
+
+/**
+ * @class allocationScope
+ * @brief Выделения памяти с момента создания объекта
+ */
+class allocationScope {
+public:
+    allocationScope() {
+        restart();
+    }
+
+    /// Начинает отсчёт заново
+    void restart() {
+        startCalls = allocationTracker::calls.load();
+        startBytes = allocationTracker::bytes.load();
+    }
+
+    /// Количество выделений с начала отсчёта
+    size_t allocations() const {
+        return allocationTracker::calls.load() - startCalls;
+    }
+
+    /// Запрошено байт с начала отсчёта
+    size_t bytes() const {
+        return allocationTracker::bytes.load() - startBytes;
+    }
+
+private:
+    size_t startCalls;
+    size_t startBytes;
+};
+
+/**
+ * @brief Фикстура UnitTest++: счётчик выделений, идущий с начала теста
+ * @details Пример бюджета: allocations.restart(); cipher.encrypt(text);
+ *          CHECK(allocations.allocations() <= 1);
+ */
+struct allocationFixture {
+    allocationScope allocations; ///< Счётчик выделений теста
+};
@@ -0,0 +1,48 @@
+/**
+ * @file alphaTable.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Таблицы русского алфавита шифров Гронсфельда
+ */
+
+#pragma once
+
+/**
+ * @struct alphaTable
+ * @brief Плотные таблицы русского алфавита, построенные на этапе компиляции
+ * @details Прямая индексация по диапазону U+0401..U+044F (Ё..я) вместо std::map:
+ *          поиск номера буквы выполняется за O(1) одним обращением к массиву.
+ *          Для символов вне алфавита возвращается -1.
+ */
+struct alphaTable {
+    static constexpr wchar_t first = L'Ё'; ///< Первый символ диапазона (U+0401)
+    static constexpr wchar_t last = L'я'; ///< Последний символ диапазона (U+044F)
+    static constexpr int size = 33; ///< Количество букв алфавита
+
+    wchar_t numAlpha[size]; ///< Алфавит по порядку "номер -> символ"
+    signed char alphaNum[last - first + 1]; ///< Массив "символ -> номер" (-1 для не-букв)
+    unsigned char utf8[size][2]; ///< Двухбайтовые UTF-8 последовательности букв
+
+    constexpr alphaTable(): numAlpha{}, alphaNum{}, utf8{} {
+        const wchar_t letters[] = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+        for (int i = 0; i < last - first + 1; i++)
+            alphaNum[i] = -1;
+        for (int i = 0; i < size; i++) {
+            numAlpha[i] = letters[i];
+            alphaNum[letters[i] - first] = i;
+            utf8[i][0] = static_cast<unsigned char>(0xC0 | (letters[i] >> 6));
+            utf8[i][1] = static_cast<unsigned char>(0x80 | (letters[i] & 0x3F));
+        }
+    }
+
+    /**
+     * @brief Возвращает номер буквы в алфавите
+     * @param c Символ
+     * @return Номер 0..32 или -1, если символ не является прописной русской буквой
+     */
+    constexpr int index(wchar_t c) const {
+        return static_cast<unsigned long>(c - first) <= static_cast<unsigned long>(last - first) ?
+               alphaNum[c - first] : -1;
+    }
+};
@@ -0,0 +1,484 @@
+/**
+ * @file benchmark.cpp
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-18
+ * @brief Замер производительности всех классов шифров лабораторных работ
+ * @details Измеряет encrypt/decrypt шифра Гронсфельда modAlphaCipher (std::wstring из Lb_2_1
+ *          и std::string из Lb_4/1), маршрутных шифров code (Lb_4/2), Cipher (Lb_2_2) и
+ *          маршрутного modAlphaCipher (Lb_1_2_5, обе разновидности строк) на текстах
+ *          от 16 Б до 1 ГБ, нескольких длинах ключа и алфавитах. Результат выводится
+ *          в stdout в формате JSON: для каждого замера скорость в МБ/с и время на символ в нс,
+ *          а также показания аппаратных счётчиков (perfCounters.h) на символ.
+ *          Классы разных лабораторных называются одинаково, поэтому исходники каждой
+ *          лабораторной включаются в собственное пространство имён.
+ *          Сборка: g++ -std=c++17 -O2 benchmark.cpp shiftKernel.cpp -o benchmark -pthread
+ *          Запуск: ./benchmark [--max-size байт] [--min-time с] [--filter подстрока] [--stats] > result.json
+ *          С --stats в каждую запись добавляется статистика этапов (cipherStats.h); её собирают
+ *          только Lb_4/1 и Lb_4/2 и только при сборке с -DCIPHER_STATS.
+ */
+
+// Стандартные заголовки и заголовки библиотеки подключаются до исходников лабораторных,
+// чтобы повторные включения внутри пространств имён были пропущены
+#include "alphaTable.h"
+#include "cipherStats.h"
+#include "mappedFile.h"
+#include "perfCounters.h"
+#include "permutationCache.h"
+#include "routePolicy.h"
+#include "shiftKernel.h"
+#include <algorithm>
+#include <chrono>
+#include <codecvt>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <locale>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// Шифр Гронсфельда на std::wstring (Lab 2.1)
+namespace lb21 {
+#include "../Lb_2_1/Lb_2_1/modAlphaCipher.h"
+#include "../Lb_2_1/Lb_2_1/modAlphaCipher.cpp"
+}
+
+/// Шифр Гронсфельда на std::string в UTF-8 (Lab 4.1)
+namespace lb41 {
+#include "../Lb_4/1/modAlphaCipher.h"
+#include "../Lb_4/1/modAlphaCIpher.cpp"
+}
+
+/// Маршрутный шифр code (Lab 4.2)
+namespace lb42 {
+#include "../Lb_4/2/route.h"
+#include "../Lb_4/2/route.cpp"
+}
+
+/// Маршрутный шифр Cipher (Lab 2.2)
+namespace lb22 {
+#include "../Lb_2_2/Lb_2_2/TableRouteCipher.h"
+#include "../Lb_2_2/Lb_2_2/TableRouteCipher.cpp"
+}
+
+/// Маршрутный modAlphaCipher (Lab 1.2.5)
+namespace lb125 {
+#include "../Lb_1_2_5/modAlphaCipher.h"
+#include "../Lb_1_2_5/modAlphaCipher.cpp"
+}
+
+/**
+ * @brief Набор символов, из которых составляется текст замера
+ */
+struct alphabet {
+    const char* name;        ///< Имя в результатах
+    std::wstring letters;    ///< Допустимые символы
+    std::wstring separators; ///< Символы между словами (пусто - сплошной текст)
+};
+
+/**
+ * @brief Текст замера в двух представлениях
+ * @details Широкая строка строится только для классов на std::wstring и только один раз.
+ */
+class sample {
+public:
+    /**
+     * @brief Формирует случайный текст
+     * @param a Алфавит
+     * @param bytes Желаемый размер в байтах UTF-8
+     */
+    sample(const alphabet& a, size_t bytes) {
+        std::mt19937 gen(static_cast<unsigned>(bytes));
+        text.reserve(bytes + 4);
+        while (text.size() < bytes) {
+            wchar_t c = a.letters[gen() % a.letters.size()];
+            if (!a.separators.empty() && gen() % 6 == 0)
+                c = a.separators[gen() % a.separators.size()];
+            append(text, c);
+            if (text.size() > bytes)
+                text.resize(text.size() - (c < 0x80 ? 1 : 2));
+            else
+                count++;
+        }
+    }
+
+    const std::string& utf8() const { return text; } ///< Текст в UTF-8
+    size_t chars() const { return count; }           ///< Количество символов
+
+    /// Текст в виде широкой строки
+    const std::wstring& wide() const {
+        if (wtext.size() != count)
+            wtext = widen(text);
+        return wtext;
+    }
+
+    /**
+     * @brief Добавляет символ в строку UTF-8 (достаточно двухбайтовых последовательностей)
+     */
+    static void append(std::string& s, wchar_t c) {
+        if (c < 0x80) {
+            s.push_back(static_cast<char>(c));
+        } else {
+            s.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            s.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+
+    /**
+     * @brief Переводит строку UTF-8 из одно- и двухбайтовых символов в широкую
+     */
+    static std::wstring widen(const std::string& s) {
+        std::wstring w;
+        w.reserve(s.size());
+        for (size_t i = 0; i < s.size(); i++) {
+            unsigned char b = s[i];
+            if (b < 0x80)
+                w.push_back(b);
+            else
+                w.push_back(static_cast<wchar_t>(((b & 0x1F) << 6) | (s[++i] & 0x3F)));
+        }
+        return w;
+    }
+
+    /**
+     * @brief Переводит широкую строку в UTF-8
+     */
+    static std::string narrow(const std::wstring& w) {
+        std::string s;
+        s.reserve(w.size() * 2);
+        for (wchar_t c : w)
+            append(s, c);
+        return s;
+    }
+
+private:
+    std::string text;
+    size_t count = 0;
+    mutable std::wstring wtext;
+};
+
+/**
+ * @brief Подготовленный замер: объект шифра и его входные данные
+ * @details run() выполняет одну операцию; размер её входа измеряется в байтах UTF-8
+ *          и в символах, чтобы разные типы строк сравнивались на одной шкале.
+ */
+struct job {
+    std::function<void()> run; ///< Одна операция шифрования или расшифрования
+    size_t bytes = 0;          ///< Размер входа в байтах UTF-8
+    size_t chars = 0;          ///< Размер входа в символах
+};
+
+/// Размер строки UTF-8 в байтах
+static size_t utf8Bytes(const std::string& s) { return s.size(); }
+/// Размер широкой строки в байтах UTF-8 (символы замера занимают 1 или 2 байта)
+static size_t utf8Bytes(const std::wstring& s) {
+    return std::accumulate(s.begin(), s.end(), size_t(0), [](size_t n, wchar_t c) { return n + (c < 0x80 ? 1 : 2); });
+}
+/// Количество символов строки UTF-8
+static size_t charCount(const std::string& s) {
+    return std::count_if(s.begin(), s.end(), [](char c) { return (static_cast<unsigned char>(c) & 0xC0) != 0x80; });
+}
+/// Количество символов широкой строки
+static size_t charCount(const std::wstring& s) { return s.size(); }
+
+/**
+ * @brief Класс шифра, участвующий в замерах
+ */
+struct target {
+    const char* cipher;                  ///< Имя класса
+    const char* lab;                     ///< Лабораторная работа
+    const char* string;                  ///< Тип строки интерфейса
+    const char* keyUnit;                 ///< Что означает длина ключа
+    std::vector<std::string> alphabets;  ///< Допустимые алфавиты
+    std::vector<size_t> keys;            ///< Длины ключа
+    /// Готовит замер; пустой run означает, что сочетание недопустимо для класса
+    std::function<job(const sample&, size_t key, bool decrypt)> prepare;
+};
+
+/**
+ * @brief Ключ Гронсфельда из прописных русских букв, кроме Ё (её не принимает Lb_4/1), без повторения одной буквы
+ * @param length Количество букв
+ */
+static std::wstring gronsfeldKey(size_t length) {
+    const std::wstring letters = L"БВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    std::wstring key;
+    for (size_t i = 0; i < length; i++)
+        key.push_back(letters[(i * 7 + 3) % letters.size()]);
+    return key;
+}
+
+/**
+ * @brief Общая подготовка замера: шифртекст для расшифрования строится заранее
+ * @param cipher Объект шифра
+ * @param in Открытый текст
+ * @param decrypt true - замер расшифрования
+ * @param enc Функция шифрования (cipher, text) -> result
+ * @param dec Функция расшифрования (cipher, text) -> result
+ */
+template <class C, class S, class E, class D>
+static job makeJob(std::shared_ptr<C> cipher, const S& in, bool decrypt, E enc, D dec) {
+    auto text = std::make_shared<S>(decrypt ? enc(*cipher, in) : in);
+    auto out = std::make_shared<S>();
+    job j;
+    if (decrypt)
+        j.run = [=] { *out = dec(*cipher, *text); };
+    else
+        j.run = [=] { *out = enc(*cipher, *text); };
+    j.bytes = utf8Bytes(*text);
+    j.chars = charCount(*text);
+    return j;
+}
+
+/**
+ * @brief Список классов шифров
+ */
+static std::vector<target> targets() {
+    const std::vector<std::string> russian = {"cyrillic_upper", "cyrillic", "cyrillic_text"};
+    const std::vector<std::string> latin = {"latin_upper", "latin"};
+    const std::vector<size_t> gronsfeld = {1, 8, 64};
+    const std::vector<size_t> columns = {2, 16, 1024};
+
+    std::vector<target> list;
+    list.push_back({"modAlphaCipher", "Lb_2_1", "std::wstring", "letters", russian, gronsfeld,
+        [=](const sample& s, size_t key, bool decrypt) {
+            auto c = std::make_shared<lb21::modAlphaCipher>(gronsfeldKey(key));
+            return makeJob(c, s.wide(), decrypt,
+                           [](lb21::modAlphaCipher& c, const std::wstring& t) { return c.encrypt(t); },
+                           [](lb21::modAlphaCipher& c, const std::wstring& t) { return c.decrypt(t); });
+        }});
+    list.push_back({"modAlphaCipher", "Lb_4/1", "std::string", "letters", russian, gronsfeld,
+        [=](const sample& s, size_t key, bool decrypt) {
+            auto c = std::make_shared<lb41::modAlphaCipher>(sample::narrow(gronsfeldKey(key)));
+            return makeJob(c, s.utf8(), decrypt,
+                           [](lb41::modAlphaCipher& c, const std::string& t) { return c.encrypt(t); },
+                           [](lb41::modAlphaCipher& c, const std::string& t) { return c.decrypt(t); });
+        }});
+    list.push_back({"code", "Lb_4/2", "std::string", "columns", latin, columns,
+        [=](const sample& s, size_t key, bool decrypt) {
+            if (key > s.utf8().size())
+                return job{};
+            auto c = std::make_shared<lb42::code>(int(key), s.utf8());
+            return makeJob(c, s.utf8(), decrypt,
+                           [](lb42::code& c, const std::string& t) { return c.encryption(t); },
+                           [](lb42::code& c, const std::string& t) { return c.transcript(t); });
+        }});
+    list.push_back({"Cipher", "Lb_2_2", "std::string", "columns", latin, columns,
+        [=](const sample& s, size_t key, bool decrypt) {
+            if (key > s.utf8().size())
+                return job{};
+            auto c = std::make_shared<lb22::Cipher>(int(key), s.utf8());
+            return makeJob(c, s.utf8(), decrypt,
+                           [](lb22::Cipher& c, std::string t) { return c.encryption(t); },
+                           [](lb22::Cipher& c, const std::string& t) { return c.transcript(t); });
+        }});
+    list.push_back({"modAlphaCipher", "Lb_1_2_5", "std::wstring", "columns", russian, columns,
+        [=](const sample& s, size_t key, bool decrypt) {
+            auto c = std::make_shared<lb125::modAlphaCipher>(int(key));
+            return makeJob(c, s.wide(), decrypt,
+                           [](lb125::modAlphaCipher& c, const std::wstring& t) { return c.encrypt(t); },
+                           [](lb125::modAlphaCipher& c, const std::wstring& t) { return c.decrypt(t); });
+        }});
+    list.push_back({"modAlphaCipher", "Lb_1_2_5", "std::string", "columns", russian, columns,
+        [=](const sample& s, size_t key, bool decrypt) {
+            auto c = std::make_shared<lb125::modAlphaCipher>(int(key));
+            return makeJob(c, s.utf8(), decrypt,
+                           [](lb125::modAlphaCipher& c, const std::string& t) { return c.encrypt(t); },
+                           [](lb125::modAlphaCipher& c, const std::string& t) { return c.decrypt(t); });
+        }});
+    return list;
+}
+
+/**
+ * @brief Результат одного замера
+ */
+struct measurement {
+    size_t iterations;             ///< Количество выполненных операций
+    double seconds;                ///< Суммарное время
+    perfCounters::reading counters; ///< Показания счётчиков за те же операции
+    size_t runs;                    ///< Всего вызовов, включая прогрев и незачтённые прогоны
+};
+
+/**
+ * @brief Выполняет операцию, удваивая число повторов, пока время не превысит minTime
+ * @details Первый вызов прогревает кэши и аллокатор и в замер не входит, кроме случая,
+ *          когда он сам дольше minTime (большие тексты не повторяются). Счётчики
+ *          запускаются на каждый прогон, в результат идут показания зачтённого.
+ */
+static measurement measure(const job& j, double minTime, perfCounters& counters) {
+    perfCounters::reading r;
+    size_t runs = 0;
+    auto timed = [&](size_t n) {
+        runs += n;
+        counters.start();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++)
+            j.run();
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+        r = counters.stop();
+        return d.count();
+    };
+    double t = timed(1);
+    if (t >= minTime)
+        return {1, t, r, runs};
+    size_t n = 1;
+    for (;;) {
+        t = timed(n);
+        if (t >= minTime || n >= (size_t(1) << 30))
+            return {n, t, r, runs};
+        double scale = t > 0 ? minTime / t * 1.2 : 16;
+        n = std::max(n * 2, static_cast<size_t>(n * std::min(scale, 16.0)));
+    }
+}
+
+/**
+ * @brief Экранирует строку для JSON (в именах встречаются только печатные ASCII)
+ */
+static std::string quoted(const std::string& s) {
+    std::string r = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            r.push_back('\\');
+        r.push_back(c);
+    }
+    return r + "\"";
+}
+
+/**
+ * @brief Главная функция
+ * @param argc Количество аргументов
+ * @param argv --max-size (по умолчанию 1 ГБ), --min-time (0.2 с), --filter, --stats
+ * @return 0 при успехе, 1 при неверных аргументах
+ */
+int main(int argc, char** argv) {
+    size_t maxSize = size_t(1) << 30;
+    double minTime = 0.2;
+    std::string filter;
+    bool stats = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--max-size" && i + 1 < argc) {
+            maxSize = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--stats") {
+            stats = true;
+        } else {
+            std::cerr << "Использование: " << argv[0]
+                      << " [--max-size байт] [--min-time с] [--filter подстрока] [--stats]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::wstring upperRu = L"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+    const std::wstring lowerRu = L"абвгдеёжзийклмнопрстуфхцчшщъыьэюя";
+    const std::wstring upperEn = L"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const std::wstring lowerEn = L"abcdefghijklmnopqrstuvwxyz";
+    const std::vector<alphabet> alphabets = {
+        {"latin_upper", upperEn, L""},
+        {"latin", upperEn + lowerEn, L""},
+        {"cyrillic_upper", upperRu, L""},
+        {"cyrillic", upperRu + lowerRu, L""},
+        {"cyrillic_text", upperRu + lowerRu, L" ,.!-"},
+    };
+    std::vector<size_t> sizes;
+    for (size_t s = 16; s <= maxSize; s *= 16)
+        sizes.push_back(s);
+    if (maxSize >= (size_t(1) << 30))
+        sizes.push_back(size_t(1) << 30);
+
+    std::vector<target> list = targets();
+    perfCounters counters;
+    std::cout << "{\n  \"context\": {\"min_time\": " << minTime << ", \"max_size\": " << maxSize
+              << ", \"compiler\": " << quoted(__VERSION__) << ", \"counters\": {";
+    for (int e = 0; e < perfCounters::eventCount; e++) {
+        perfCounters::event ev = perfCounters::event(e);
+        std::cout << (e ? ", " : "") << quoted(perfCounters::name(ev)) << ": "
+                  << (counters.available(ev) ? std::string("\"ok\"") : quoted(counters.why(ev)));
+    }
+    std::cout << "}},\n  \"benchmarks\": [";
+    bool first = true;
+    for (const alphabet& a : alphabets) {
+        for (size_t size : sizes) {
+            std::unique_ptr<sample> s;
+            for (const target& t : list) {
+                if (std::find(t.alphabets.begin(), t.alphabets.end(), a.name) == t.alphabets.end())
+                    continue;
+                std::string name = std::string(t.cipher) + " " + t.lab + " " + t.string;
+                if (!filter.empty() && name.find(filter) == std::string::npos)
+                    continue;
+                if (!s)
+                    s.reset(new sample(a, size));
+                for (size_t key : t.keys) {
+                    for (bool decrypt : {false, true}) {
+                        const char* op = decrypt ? "decrypt" : "encrypt";
+                        std::cerr << name << " " << op << " " << a.name << " key " << key
+                                  << " size " << size << std::endl;
+                        job j;
+                        try {
+                            j = t.prepare(*s, key, decrypt);
+                        } catch (const std::exception& e) {
+                            std::cerr << "  пропущено: " << e.what() << std::endl;
+                            continue;
+                        }
+                        if (!j.run)
+                            continue;
+                        cipherStats::snapshot before = cipherStats::take();
+                        measurement m = measure(j, minTime, counters);
+                        cipherStats::snapshot d = cipherStats::difference(cipherStats::take(), before);
+                        double each = m.seconds / m.iterations;
+                        std::cout << (first ? "\n" : ",\n") << "    {\"cipher\": " << quoted(t.cipher)
+                                  << ", \"lab\": " << quoted(t.lab) << ", \"string\": " << quoted(t.string)
+                                  << ", \"operation\": " << quoted(op) << ", \"alphabet\": " << quoted(a.name)
+                                  << ", \"key_length\": " << key << ", \"key_unit\": " << quoted(t.keyUnit)
+                                  << ", \"bytes\": " << j.bytes << ", \"chars\": " << j.chars
+                                  << ", \"iterations\": " << m.iterations << ", \"seconds\": " << m.seconds
+                                  << ", \"mb_per_s\": " << j.bytes / each / 1e6
+                                  << ", \"ns_per_char\": " << each * 1e9 / j.chars;
+                        // Недоступные счётчики выводятся как null, чтобы набор полей не менялся
+                        double perChar = double(m.iterations) * j.chars;
+                        for (int e = 0; e < perfCounters::eventCount; e++) {
+                            std::cout << ", \"" << perfCounters::name(perfCounters::event(e)) << "_per_char\": ";
+                            if (m.counters.valid[e])
+                                std::cout << m.counters.value[e] / perChar;
+                            else
+                                std::cout << "null";
+                        }
+                        // Статистика включает прогревочный вызов и все прогоны, поэтому
+                        // выводятся доли времени этапов и выделения на одну операцию
+                        if (stats && d.enabled) {
+                            uint64_t total = 0;
+                            for (const cipherStats::stageStats& st : d.stages)
+                                total += st.nanoseconds;
+                            if (total) {
+                                std::cout << ", \"stages\": {";
+                                for (int i = 0; i < cipherStats::stageCount; i++)
+                                    std::cout << (i ? ", " : "") << quoted(cipherStats::name(cipherStats::stage(i)))
+                                              << ": " << double(d.stages[i].nanoseconds) / total;
+                                std::cout << "}, \"allocations_per_op\": "
+                                          << double(d.allocations) / m.runs;
+                            }
+                        }
+                        std::cout << "}";
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
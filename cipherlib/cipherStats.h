@@ -0,0 +1,193 @@
+/**
+ * @file cipherStats.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-20
+ * @brief Поэтапная статистика горячего пути шифров
+ * @details Шифры отмечают время, объём данных и выделения памяти по этапам:
+ *          проверка текста, декодирование UTF-8 в номера букв, преобразование (сдвиг
+ *          или перестановка) и кодирование результата. Если этапы выполняются в одном
+ *          проходе, время относится к этапу, в котором выполняется проход (например,
+ *          проверка UTF-8 в шифре Гронсфельда входит в декодирование).
+ *          Счётчики общие для всех потоков и объектов; снимок take() можно брать в
+ *          любой момент. Статистика включается при сборке с -DCIPHER_STATS; без этого
+ *          флага все отметки - пустые встроенные функции и из кода исчезают.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#ifdef CIPHER_STATS
+#include <atomic>
+#include <chrono>
+#endif
+
+namespace cipherStats {
+
+/// Этапы обработки текста
+enum stage {
+    validate,   ///< Отдельная проверка или фильтрация текста
+    decode,     ///< Разбор UTF-8 в номера букв (вместе с проверкой, если она в том же проходе)
+    transform,  ///< Сдвиг Гронсфельда или маршрутная перестановка
+    encode,     ///< Запись результата в UTF-8
+    stageCount  ///< Количество этапов
+};
+
+/// Счётчики одного этапа
+struct stageStats {
+    uint64_t nanoseconds; ///< Суммарное время
+    uint64_t bytes;       ///< Обработано байт (для transform - символов)
+    uint64_t calls;       ///< Количество отметок этапа
+};
+
+/// Снимок всех счётчиков
+struct snapshot {
+    bool enabled;                  ///< Статистика собрана с -DCIPHER_STATS
+    stageStats stages[stageCount]; ///< Счётчики по этапам
+    uint64_t allocations;          ///< Выделений памяти в шифрах
+    uint64_t allocatedBytes;       ///< Выделено байт
+};
+
+/**
+ * @brief Имя этапа в выводе
+ */
+inline const char* name(stage s) {
+    static const char* const names[stageCount] = {"validate", "decode", "transform", "encode"};
+    return names[s];
+}
+
+#ifdef CIPHER_STATS
+
+/// Счётчики процесса
+struct counters {
+    std::atomic<uint64_t> nanoseconds[stageCount]; ///< Время этапов
+    std::atomic<uint64_t> bytes[stageCount];       ///< Объём этапов
+    std::atomic<uint64_t> calls[stageCount];       ///< Отметки этапов
+    std::atomic<uint64_t> allocations;             ///< Выделения памяти
+    std::atomic<uint64_t> allocatedBytes;          ///< Выделенные байты
+};
+
+inline counters global{}; ///< Единственный набор счётчиков
+
+/**
+ * @class stageClock
+ * @brief Секундомер, относящий время с прошлой отметки к указанному этапу
+ */
+class stageClock {
+public:
+    stageClock(): last(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Относит время с прошлой отметки к этапу
+     * @param s Этап
+     * @param bytes Объём данных, обработанных этапом за это время
+     */
+    void charge(stage s, size_t bytes) {
+        auto now = std::chrono::steady_clock::now();
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        global.nanoseconds[s].fetch_add(ns, std::memory_order_relaxed);
+        global.bytes[s].fetch_add(bytes, std::memory_order_relaxed);
+        global.calls[s].fetch_add(1, std::memory_order_relaxed);
+        last = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+};
+
+/**
+ * @brief Отмечает выделение памяти шифром
+ * @param bytes Размер выделения
+ */
+inline void allocation(size_t bytes) {
+    global.allocations.fetch_add(1, std::memory_order_relaxed);
+    global.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает текущие значения счётчиков
+ */
+inline snapshot take() {
+    snapshot r{};
+    r.enabled = true;
+    for (int s = 0; s < stageCount; s++) {
+        r.stages[s].nanoseconds = global.nanoseconds[s].load(std::memory_order_relaxed);
+        r.stages[s].bytes = global.bytes[s].load(std::memory_order_relaxed);
+        r.stages[s].calls = global.calls[s].load(std::memory_order_relaxed);
+    }
+    r.allocations = global.allocations.load(std::memory_order_relaxed);
+    r.allocatedBytes = global.allocatedBytes.load(std::memory_order_relaxed);
+    return r;
+}
+
+/**
+ * @brief Обнуляет счётчики
+ */
+inline void reset() {
+    for (int s = 0; s < stageCount; s++) {
+        global.nanoseconds[s].store(0, std::memory_order_relaxed);
+        global.bytes[s].store(0, std::memory_order_relaxed);
+        global.calls[s].store(0, std::memory_order_relaxed);
+    }
+    global.allocations.store(0, std::memory_order_relaxed);
+    global.allocatedBytes.store(0, std::memory_order_relaxed);
+}
+
+#else
+
+/// Пустой секундомер сборки без статистики
+class stageClock {
+public:
+    void charge(stage, size_t) {}
+};
+
+inline void allocation(size_t) {}
+
+inline snapshot take() {
+    return snapshot{};
+}
+
+inline void reset() {}
+
+#endif
+
+/**
+ * @brief Разность снимков: что накопилось между before и after
+ */
+inline snapshot difference(const snapshot& after, const snapshot& before) {
+    snapshot r = after;
+    for (int s = 0; s < stageCount; s++) {
+        r.stages[s].nanoseconds -= before.stages[s].nanoseconds;
+        r.stages[s].bytes -= before.stages[s].bytes;
+        r.stages[s].calls -= before.stages[s].calls;
+    }
+    r.allocations -= before.allocations;
+    r.allocatedBytes -= before.allocatedBytes;
+    return r;
+}
+
+/**
+ * @brief Печатает снимок таблицей: этап, время, доля времени, объём
+ * @param out Поток вывода
+ * @param s Снимок
+ */
+inline void print(std::ostream& out, const snapshot& s) {
+    if (!s.enabled) {
+        out << "Статистика этапов не собрана: соберите с -DCIPHER_STATS" << std::endl;
+        return;
+    }
+    uint64_t total = 0;
+    for (int i = 0; i < stageCount; i++)
+        total += s.stages[i].nanoseconds;
+    for (int i = 0; i < stageCount; i++) {
+        const stageStats& st = s.stages[i];
+        out << name(stage(i)) << ": " << st.nanoseconds / 1e6 << " мс ("
+            << (total ? 100.0 * st.nanoseconds / total : 0.0) << "%), " << st.bytes << " байт, "
+            << st.calls << " отметок" << std::endl;
+    }
+    out << "allocations: " << s.allocations << " (" << s.allocatedBytes << " байт)" << std::endl;
+}
+
+} // namespace cipherStats
@@ -0,0 +1,488 @@
+/**
+ * @file conformance.cpp
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-16
+ * @brief Проверка соответствия ядер cipherlib и классов лабораторных прежним реализациям
+ * @details Каждый класс лабораторных работ теперь только проверяет текст и вызывает
+ *          ядро библиотеки. Прежние циклы сохранены здесь как эталоны и сравниваются с
+ *          ядрами на случайных текстах и ключах. Сами классы (modAlphaCipher, Cipher, code
+ *          всех лабораторных) собираются здесь же, каждый в своём пространстве имён, и
+ *          сравниваются с результатами и сообщениями об ошибках исходных классов из
+ *          conformanceVectors.h: так проверяются и проверка текста, и регистр, и хвост
+ *          таблицы, которых ядра не касаются.
+ *          Сборка: g++ -std=c++17 -O2 conformance.cpp shiftKernel.cpp -o conformance -lUnitTest++ -pthread
+ */
+
+#include <UnitTest++/UnitTest++.h>
+#include "alphaTable.h"
+#include "cipherStats.h"
+#include "conformanceVectors.h"
+#include "mappedFile.h"
+#include "permutationCache.h"
+#include "routePolicy.h"
+#include "shiftKernel.h"
+#include <algorithm>
+#include <codecvt>
+#include <cstdio>
+#include <cstring>
+#include <cwctype>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Классы лабораторных: у всех одинаковые имена, поэтому каждый в своём пространстве
+// имён. Заголовки cipherlib и стандартной библиотеки уже подключены выше и внутри
+// пространств имён повторно не раскрываются
+namespace lb11 {
+#include "../Lb_1_1/Lb_1/modAlphaCipher.h"
+#include "../Lb_1_1/Lb_1/modAlphaCipher.cpp"
+}
+namespace lb21 {
+#include "../Lb_2_1/Lb_2_1/modAlphaCipher.h"
+#include "../Lb_2_1/Lb_2_1/modAlphaCipher.cpp"
+}
+namespace lb31 {
+#include "../Lb_3_1/modAlphaCipher.h"
+#include "../Lb_3_1/modAlphaCipher.cpp"
+}
+namespace lb41 {
+#include "../Lb_4/1/modAlphaCipher.h"
+#include "../Lb_4/1/modAlphaCIpher.cpp"
+}
+namespace lb12 {
+#include "../Lb_1_2_1-4/Lb_1_2/modAlphaCipher.h"
+#include "../Lb_1_2_1-4/Lb_1_2/modAlphaCipher.cpp"
+}
+namespace lb125 {
+#include "../Lb_1_2_5/modAlphaCipher.h"
+#include "../Lb_1_2_5/modAlphaCipher.cpp"
+}
+namespace lb22 {
+#include "../Lb_2_2/Lb_2_2/TableRouteCipher.h"
+#include "../Lb_2_2/Lb_2_2/TableRouteCipher.cpp"
+}
+namespace lb32 {
+#include "../Lb_3_2/route.h"
+#include "../Lb_3_2/route.cpp"
+}
+namespace lb42 {
+#include "../Lb_4/2/route.h"
+#include "../Lb_4/2/route.cpp"
+}
+
+/**
+ * @brief Прежний цикл Гронсфельда (Lb_1_1, Lb_2_1, Lb_3_1)
+ */
+static void referenceShift(std::vector<int>& work, const std::vector<int>& key, bool inverse) {
+    for (unsigned i = 0; i < work.size(); i++)
+        work[i] = inverse ? (work[i] + 33 - key[i % key.size()]) % 33 : (work[i] + key[i % key.size()]) % 33;
+}
+
+/**
+ * @brief Прежняя таблица Lb_1_2_1-4 и Lb_1_2_5: чтение столбцов справа налево сверху вниз
+ */
+template <class S>
+static S referenceRightToLeft(const S& t, int key) {
+    int len = t.size();
+    int rows = (len + key - 1) / key;
+    S result;
+    for (int j = key - 1; j >= 0; j--)
+        for (int i = 0; i < rows; i++)
+            if (i * key + j < len)
+                result.push_back(t[i * key + j]);
+    return result;
+}
+
+/**
+ * @brief Прежняя таблица Lb_2_2: чтение столбцов справа налево снизу вверх
+ */
+static std::string referenceBottomUp(const std::string& t, int key) {
+    int len = t.size();
+    int rows = (len + key - 1) / key;
+    std::string result;
+    for (int j = key - 1; j >= 0; j--)
+        for (int i = rows - 1; i >= 0; i--)
+            if (i * key + j < len)
+                result += t[i * key + j];
+    return result;
+}
+
+/**
+ * @brief Прежняя таблица code (Lb_3_2, Lb_4/2): только полные строки, хвост на месте
+ */
+static std::string referenceCode(const std::string& t, int key) {
+    int rows = t.size() / key;
+    std::string result = t;
+    int k = 0;
+    for (int j = key - 1; j >= 0; j--)
+        for (int i = 0; i < rows; i++)
+            result[k++] = t[i * key + j];
+    return result;
+}
+
+/// UTF-8 -> std::wstring для классов лабораторных на широких строках
+static std::wstring widen(const std::string& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> codec;
+    return codec.from_bytes(s);
+}
+
+/// std::wstring -> UTF-8
+static std::string narrow(const std::wstring& s) {
+    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> codec;
+    return codec.to_bytes(s);
+}
+
+/// Результат вызова: текст или "!" и сообщение исключения
+template <class F>
+static std::string outcome(F f) {
+    try {
+        return f();
+    } catch (const std::exception& e) {
+        return std::string("!") + e.what();
+    }
+}
+
+/**
+ * @brief Вызывает класс лабораторной работы через его исходный интерфейс
+ * @param lab Лабораторная ("Lb_2_1", "Lb_4/2", ...); "Lb_1_2_5/utf8" - варианты для UTF-8
+ * @param key Ключ: строка для шифров Гронсфельда, число столбцов для маршрутных
+ * @param decrypt Расшифрование вместо шифрования
+ * @param in Входной текст в UTF-8
+ * @param aux Текст для конструктора и открытый текст transcript (Lb_2_2, Lb_3_2, Lb_4/2)
+ */
+static std::string runFacade(const std::string& lab, const std::string& key, bool decrypt, const std::string& in,
+                             const std::string& aux) {
+    return outcome([&]() -> std::string {
+        if (lab == "Lb_1_1") {
+            lb11::modAlphaCipher c(widen(key));
+            return narrow(decrypt ? c.decrypt(widen(in)) : c.encrypt(widen(in)));
+        }
+        if (lab == "Lb_2_1") {
+            lb21::modAlphaCipher c(widen(key));
+            return narrow(decrypt ? c.decrypt(widen(in)) : c.encrypt(widen(in)));
+        }
+        if (lab == "Lb_3_1") {
+            lb31::modAlphaCipher c(key);
+            return decrypt ? c.decrypt(in) : c.encrypt(in);
+        }
+        if (lab == "Lb_4/1") {
+            lb41::modAlphaCipher c(key);
+            return decrypt ? c.decrypt(in) : c.encrypt(in);
+        }
+        if (lab == "Lb_1_2_1-4") {
+            lb12::modAlphaCipher c(std::stoi(key));
+            return narrow(decrypt ? c.decrypt(widen(in)) : c.encrypt(widen(in)));
+        }
+        if (lab == "Lb_1_2_5") {
+            lb125::modAlphaCipher c(std::stoi(key));
+            return narrow(decrypt ? c.decrypt(widen(in)) : c.encrypt(widen(in)));
+        }
+        if (lab == "Lb_1_2_5/utf8") {
+            lb125::modAlphaCipher c(std::stoi(key));
+            return decrypt ? c.decrypt(in) : c.encrypt(in);
+        }
+        if (lab == "Lb_2_2") {
+            lb22::Cipher c(std::stoi(key), aux);
+            std::string t = in, open = aux;
+            return decrypt ? c.transcript(t, open) : c.encryption(t);
+        }
+        if (lab == "Lb_3_2") {
+            lb32::code c(std::stoi(key), aux);
+            return decrypt ? c.transcript(in, aux) : c.encryption(in);
+        }
+        lb42::code c(std::stoi(key), aux);
+        return decrypt ? c.transcript(in, aux) : c.encryption(in);
+    });
+}
+
+/// FNV-1a, 64 бита
+static uint64_t fnv1a(const std::string& s) {
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s)
+        h = (h ^ c) * 1099511628211ull;
+    return h;
+}
+
+/**
+ * @brief Детерминированный текст из символов набора (каждый символ - строка UTF-8)
+ */
+static std::string facadeText(const std::vector<std::string>& symbols, size_t n, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::string s;
+    for (size_t i = 0; i < n; i++)
+        s += symbols[gen() % symbols.size()];
+    return s;
+}
+
+/// Разбивает строку UTF-8 (латиница и кириллица) на символы
+static std::vector<std::string> symbolsOf(const std::string& s) {
+    std::vector<std::string> r;
+    for (size_t i = 0; i < s.size();) {
+        size_t n = (static_cast<unsigned char>(s[i]) & 0xE0) == 0xC0 ? 2 : 1;
+        r.push_back(s.substr(i, n));
+        i += n;
+    }
+    return r;
+}
+
+template <class S>
+static S randomText(std::mt19937& gen, size_t n) {
+    S s(n, 0);
+    for (auto& c : s)
+        c = static_cast<typename S::value_type>('A' + gen() % 26);
+    return s;
+}
+
+#ifdef __linux__
+/**
+ * @brief На время жизни объекта ограничивает адресное пространство процесса
+ * @details Предел - текущий размер плюс spare байт: стек нового потока (8 МБ) в него не
+ *          помещается, поэтому std::thread выбрасывает std::system_error, как при
+ *          нехватке ресурсов.
+ */
+class addressSpaceLimit {
+    rlimit saved;
+public:
+    explicit addressSpaceLimit(size_t spare) {
+        getrlimit(RLIMIT_AS, &saved);
+        size_t pages = 0;
+        std::ifstream("/proc/self/statm") >> pages;
+        rlimit limited = saved;
+        limited.rlim_cur = pages * sysconf(_SC_PAGESIZE) + spare;
+        setrlimit(RLIMIT_AS, &limited);
+    }
+    ~addressSpaceLimit() {
+        setrlimit(RLIMIT_AS, &saved);
+    }
+};
+#endif
+
+SUITE(GronsfeldConformance) {
+    TEST(ShiftLettersMatchesLoop) {
+        std::mt19937 gen(1);
+        for (int it = 0; it < 300; it++) {
+            std::vector<int> key(1 + gen() % 40);
+            for (auto& k : key)
+                k = gen() % 33;
+            std::vector<int> work(gen() % (it < 250 ? 200 : 20000));
+            for (auto& w : work)
+                w = gen() % 33;
+            for (bool inverse : {false, true}) {
+                std::vector<int> expected = work;
+                referenceShift(expected, key, inverse);
+                std::vector<int> actual = work;
+                shiftLetters(actual.data(), actual.size(), key, inverse);
+                CHECK(expected == actual);
+            }
+        }
+    }
+
+    TEST(EveryLevelMatchesLoop) {
+        std::mt19937 gen(2);
+        std::vector<int> key = {5, 0, 32, 17, 9, 1, 30};
+        std::vector<int> work(10007);
+        for (auto& w : work)
+            w = gen() % 33;
+        std::vector<int> expected = work;
+        referenceShift(expected, key, false);
+        std::vector<unsigned char> stream = makeKeyStream(key, false);
+        for (shiftLevel level : {shiftLevel::scalar, shiftLevel::sse42, shiftLevel::avx2}) {
+            if (!shiftLevelSupported(level))
+                continue;
+            std::vector<unsigned char> bytes(work.begin(), work.end());
+            shiftAdd(bytes.data(), bytes.size(), stream.data(), key.size(), 0, level);
+            CHECK(std::vector<int>(bytes.begin(), bytes.end()) == expected);
+        }
+    }
+
+    TEST(EmptyText) {
+        std::vector<int> key = {3};
+        shiftLetters(nullptr, 0, key, false);
+        shiftLetters(nullptr, 0, std::vector<int>(), true);
+    }
+}
+
+SUITE(RouteConformance) {
+    TEST(RightToLeftMatchesTable) {
+        std::mt19937 gen(3);
+        for (int it = 0; it < 500; it++) {
+            size_t n = 1 + gen() % (it < 450 ? 300 : 50000);
+            size_t key = 1 + gen() % (it % 2 ? 12 : 400);
+            std::string s = randomText<std::string>(gen, n);
+            std::string out(n, ' '), back(n, ' ');
+            std::string expected = referenceRightToLeft(s, int(key));
+            route::routeKernel<route::columnsRightToLeft>::apply(s.data(), &out[0], n, key, false,
+                                                                 [](char) { return true; });
+            CHECK_EQUAL(expected, out);
+            route::routeKernel<route::columnsRightToLeft>::apply(out.data(), &back[0], n, key, true,
+                                                                 [](char) { return true; });
+            CHECK_EQUAL(s, back);
+
+            std::wstring w = randomText<std::wstring>(gen, n);
+            std::wstring wout(n, L' ');
+            route::routeKernel<route::columnsRightToLeft>::apply(w.data(), &wout[0], n, key, false,
+                                                                 [](wchar_t) { return true; });
+            CHECK(referenceRightToLeft(w, int(key)) == wout);
+        }
+    }
+
+    TEST(BottomUpMatchesTable) {
+        std::mt19937 gen(4);
+        for (int it = 0; it < 500; it++) {
+            size_t n = 1 + gen() % (it < 450 ? 300 : 50000);
+            size_t key = 2 + gen() % (it % 2 ? 12 : 400);
+            std::string s = randomText<std::string>(gen, n);
+            std::string out(n, ' '), back(n, ' ');
+            route::routeKernel<route::columnsBottomUp>::apply(s.data(), &out[0], n, key, false,
+                                                              [](char) { return true; });
+            CHECK_EQUAL(referenceBottomUp(s, int(key)), out);
+            route::routeKernel<route::columnsBottomUp>::apply(out.data(), &back[0], n, key, true,
+                                                              [](char) { return true; });
+            CHECK_EQUAL(s, back);
+        }
+    }
+
+    TEST(FullRowsMatchCode) {
+        std::mt19937 gen(5);
+        for (int it = 0; it < 500; it++) {
+            size_t n = 2 + gen() % (it < 450 ? 300 : 50000);
+            size_t key = 2 + gen() % std::min<size_t>(n - 1, it % 2 ? 12 : 400);
+            std::string s = randomText<std::string>(gen, n);
+            std::string out = s;
+            size_t rows = n / key;
+            route::routeKernel<route::columnsRightToLeft>::apply(s.data(), &out[0], rows * key, key, false,
+                                                                 [](char) { return true; });
+            CHECK_EQUAL(referenceCode(s, int(key)), out);
+        }
+    }
+
+    TEST(ParallelMatchesSerial) {
+        std::mt19937 gen(6);
+        std::string s = randomText<std::string>(gen, 3 << 20);
+        for (size_t key : {2, 7, 64, 1000}) {
+            std::string serial(s.size(), ' '), parallel(s.size(), ' ');
+            route::routeKernel<route::columnsBottomUp>::apply(s.data(), &serial[0], s.size(), key, false,
+                                                              [](char) { return true; });
+            CHECK(route::routeParallel<route::columnsBottomUp>(s.data(), &parallel[0], s.size(), key, false,
+                                                               [](char) { return true; }, 4));
+            CHECK(serial == parallel);
+        }
+    }
+
+    TEST(MoreThreadsThanBands) {
+        std::mt19937 gen(8);
+        // Две полные полосы и строка третьей: потоков намного больше, чем полос
+        std::string s = randomText<std::string>(gen, 7 * (2 * routeDetail::tile + 1) - 3);
+        std::string serial(s.size(), ' '), parallel(s.size(), ' ');
+        route::routeKernel<route::columnsBottomUp>::apply(s.data(), &serial[0], s.size(), 7, true,
+                                                          [](char) { return true; });
+        CHECK(route::routeParallel<route::columnsBottomUp>(s.data(), &parallel[0], s.size(), 7, true,
+                                                           [](char) { return true; }, 64));
+        CHECK(serial == parallel);
+    }
+
+#ifdef __linux__
+    TEST(ThreadStartFailure) {
+        std::mt19937 gen(9);
+        std::string s = randomText<std::string>(gen, 1 << 20);
+        std::string serial(s.size(), ' ');
+        route::routeKernel<route::columnsBottomUp>::apply(s.data(), &serial[0], s.size(), 13, false,
+                                                          [](char) { return true; });
+        // Потоки, которым не хватило стека из кэша, не запускаются
+        std::string parallel(s.size(), ' ');
+        bool ok;
+        {
+            addressSpaceLimit limit(1 << 20);
+            ok = route::routeParallel<route::columnsBottomUp>(s.data(), &parallel[0], s.size(), 13, false,
+                                                              [](char) { return true; }, 8);
+        }
+        CHECK(ok);
+        CHECK(serial == parallel);
+    }
+#endif
+
+    TEST(CachedMapMatchesKernel) {
+        permutationCache cache(1 << 20);
+        std::mt19937 gen(7);
+        std::string s = randomText<std::string>(gen, 997);
+        permutationCache::map m = cache.getMap(13, s.size(), route::columnsRightToLeft::id, [&](uint32_t* to) {
+            route::routeMap<route::columnsRightToLeft>(to, s.size(), 13);
+        });
+        std::string mapped(s.size(), ' ');
+        for (size_t k = 0; k < s.size(); k++)
+            mapped[(*m)[k]] = s[k];
+        CHECK_EQUAL(referenceRightToLeft(s, 13), mapped);
+    }
+}
+
+SUITE(MappedFileConformance) {
+    TEST(CreateResizeRead) {
+        {
+            mappedFile out = mappedFile::create("cipherlib_map.tmp", 16, false);
+            std::copy_n("ABCDEFGHIJKLMNOP", 16, out.data());
+            out.resize(10);
+        }
+        mappedFile in = mappedFile::openRead("cipherlib_map.tmp", true);
+        CHECK_EQUAL("ABCDEFGHIJ", std::string(in.data(), in.size()));
+        in.close();
+        std::remove("cipherlib_map.tmp");
+        CHECK_THROW(mappedFile::openRead("cipherlib_missing.tmp", false), std::system_error);
+    }
+}
+
+SUITE(FacadeConformance) {
+    TEST(ShortTextsMatchBaseline) {
+        for (const facadeCase& c : facadeCases) {
+            std::string actual = runFacade(c.lab, c.key, c.decrypt, c.input, c.aux);
+            if (actual != c.expected)
+                std::cerr << c.lab << (c.decrypt ? " decrypt " : " encrypt ") << c.input << ": " << actual
+                          << " != " << c.expected << std::endl;
+            CHECK(actual == c.expected);
+            if (std::strcmp(c.lab, "Lb_1_2_5") == 0)
+                CHECK(runFacade("Lb_1_2_5/utf8", c.key, c.decrypt, c.input, c.aux) == c.expected);
+        }
+    }
+
+    TEST(LongTextsMatchBaseline) {
+        for (const facadeBulk& b : facadeBulks) {
+            std::string in = facadeText(symbolsOf(b.symbols), b.length, b.seed);
+            std::string aux = b.decrypt ? facadeText(symbolsOf(FACADE_LAT), b.length, b.seed + 1000) : in;
+            std::string actual = runFacade(b.lab, b.key, b.decrypt, in, aux);
+            if (fnv1a(actual) != b.digest)
+                std::cerr << b.lab << " key " << b.key << " length " << b.length << ": "
+                          << actual.substr(0, 40) << std::endl;
+            CHECK(fnv1a(actual) == b.digest);
+            if (std::strcmp(b.lab, "Lb_1_2_5") == 0)
+                CHECK(fnv1a(runFacade("Lb_1_2_5/utf8", b.key, b.decrypt, in, aux)) == b.digest);
+        }
+    }
+}
+
+/**
+ * @brief Главная функция запуска тестов
+ * @param argc Количество аргументов
+ * @param argv Аргументы командной строки
+ * @return Код завершения тестирования
+ */
+int main(int argc, char **argv) {
+    return UnitTest::RunAllTests();
+}
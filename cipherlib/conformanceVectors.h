@@ -0,0 +1,201 @@
+/**
+ * @file conformanceVectors.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-16
+ * @brief Эталонные результаты классов лабораторных до переноса на cipherlib
+ * @details Результаты получены сборкой исходных классов modAlphaCipher, Cipher и code
+ *          до первого изменения серии и проверяются в conformance.cpp на текущих классах.
+ *          Для исключений записан знак "!" и текст what(): классы Lb_1_2_1-4 и Lb_1_2_5
+ *          сужают широкое сообщение до младших байтов, поэтому их тексты записаны так же.
+ *          Длинные тексты строятся facadeText() из символов набора и сравниваются по
+ *          хешу FNV-1a результата.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/// Вызов класса лабораторной на коротком тексте
+struct facadeCase {
+    const char* lab;      ///< Каталог лабораторной ("Lb_2_1", "Lb_4/2", ...)
+    const char* key;      ///< Ключ: буквы для Гронсфельда, число столбцов для маршрута
+    bool decrypt;         ///< Расшифрование вместо шифрования
+    const char* input;    ///< Входной текст (UTF-8)
+    const char* aux;      ///< Текст конструктора и открытый текст (Lb_2_2, Lb_3_2, Lb_4/2)
+    const char* expected; ///< Результат или "!" и сообщение исключения
+};
+
+/// Вызов класса лабораторной на длинном сгенерированном тексте
+struct facadeBulk {
+    const char* lab;     ///< Каталог лабораторной
+    const char* key;     ///< Ключ
+    bool decrypt;        ///< Расшифрование вместо шифрования
+    const char* symbols; ///< Символы, из которых строится входной текст
+    size_t length;       ///< Длина текста в символах
+    unsigned seed;       ///< Зерно генератора
+    uint64_t digest;     ///< FNV-1a результата
+};
+
+static const facadeCase facadeCases[] = {
+    {"Lb_1_1", "КЛЮЧ", false, "ПРИВЕТМИР", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_1_1", "КЛЮЧ", true, "ЪЬЖЩПЮКБЬ", "", "ПРИВЕТМЙС"},
+    {"Lb_1_1", "Я", false, "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", "", "ЯАБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮ"},
+    {"Lb_1_1", "ЁЖИК", true, "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", "", "ЪЪЩШЮЮЭЬВВБАЁЁЕДЙЙИЗННМЛССРПХХФУЩ"},
+    {"Lb_1_1", "ДЛИННЫЙКЛЮЧДЛИННЕЕТЕКСТА", false, "ТЕКСТ", "", "ЦРУЯА"},
+    {"Lb_2_1", "КЛЮЧ", false, "ПРИВЕТМИР", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_2_1", "ключ", false, "Привет, мир!", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_2_1", "КЛЮЧ", true, "ЪЬЖЩПЮКБЬ", "", "ПРИВЕТМЙС"},
+    {"Lb_2_1", "КЛЮЧ", true, "ъьжщпюкбь", "", "ПРИВЕТМЙС"},
+    {"Lb_2_1", "Ёж", false, "ёлка ЁЛКА", "", "!Неправильный ключ: содержит недопустимые символы"},
+    {"Lb_2_1", "ДЛИННЫЙКЛЮЧ", false, "ТЕКСТ", "", "ЦРУЯА"},
+    {"Lb_2_1", "", false, "ТЕКСТ", "", "!Пустой ключ"},
+    {"Lb_2_1", "КЛ1Ч", false, "ТЕКСТ", "", "!Неправильный ключ: содержит недопустимые символы"},
+    {"Lb_2_1", "KEY", false, "ТЕКСТ", "", "!Неправильный ключ: содержит недопустимые символы"},
+    {"Lb_2_1", "КЛЮЧ", false, "", "", "!Отсутствует текст"},
+    {"Lb_2_1", "КЛЮЧ", false, "123 !?", "", "!Отсутствует текст"},
+    {"Lb_2_1", "КЛЮЧ", false, "HELLO", "", "!Отсутствует текст"},
+    {"Lb_2_1", "КЛЮЧ", true, "", "", "!Пустой текст"},
+    {"Lb_2_1", "КЛЮЧ", true, "ЪЬЖ ЩПЮ", "", "!Неправильно зашифрованный текст: содержит недопустимые символы"},
+    {"Lb_2_1", "КЛЮЧ", true, "ЪЬЖ1", "", "!Неправильно зашифрованный текст: содержит недопустимые символы"},
+    {"Lb_3_1", "КЛЮЧ", false, "ПРИВЕТМИР", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_3_1", "ключ", false, "Привет, мир!", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_3_1", "КЛЮЧ", true, "ЪЬЖЩПЮКБЬ", "", "ПРИВЕТМЙС"},
+    {"Lb_3_1", "КЛЮЧ", true, "ъьжщпюкбь", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_3_1", "Ёж", false, "ёлка ЁЛКА", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_3_1", "ДЛИННЫЙКЛЮЧ", false, "ТЕКСТ", "", "ЦРУЯА"},
+    {"Lb_3_1", "А", false, "ТЕКСТ", "", "ТЕКСТ"},
+    {"Lb_3_1", "ААА", false, "ТЕКСТ", "", "!WeakKey"},
+    {"Lb_3_1", "", false, "ТЕКСТ", "", "!Пустой ключ"},
+    {"Lb_3_1", "КЛ1Ч", false, "ТЕКСТ", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_3_1", "KEY", false, "ТЕКСТ", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_3_1", "КЛЮЧ", false, "", "", "!Отсутствует открытый текст!"},
+    {"Lb_3_1", "КЛЮЧ", false, "123 !?", "", "!Отсутствует открытый текст!"},
+    {"Lb_3_1", "КЛЮЧ", false, "HELLO", "", "!Отсутствует открытый текст!"},
+    {"Lb_3_1", "КЛЮЧ", true, "", "", "!Empty cipher text"},
+    {"Lb_3_1", "КЛЮЧ", true, "ЪЬЖ ЩПЮ", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_3_1", "КЛЮЧ", true, "ЪЬЖ1", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_4/1", "КЛЮЧ", false, "ПРИВЕТМИР", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_4/1", "ключ", false, "Привет, мир!", "", "ЪЬЖЩПЮКАЫ"},
+    {"Lb_4/1", "КЛЮЧ", true, "ЪЬЖЩПЮКБЬ", "", "ПРИВЕТМЙС"},
+    {"Lb_4/1", "КЛЮЧ", true, "ъьжщпюкбь", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_4/1", "Ёж", false, "ёлка ЁЛКА", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_4/1", "ДЛИННЫЙКЛЮЧ", false, "ТЕКСТ", "", "ЦРУЯА"},
+    {"Lb_4/1", "А", false, "ТЕКСТ", "", "ТЕКСТ"},
+    {"Lb_4/1", "ААА", false, "ТЕКСТ", "", "!WeakKey"},
+    {"Lb_4/1", "", false, "ТЕКСТ", "", "!Пустой ключ"},
+    {"Lb_4/1", "КЛ1Ч", false, "ТЕКСТ", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_4/1", "KEY", false, "ТЕКСТ", "", "!Неверный ключ: содержит не-буквенные символы"},
+    {"Lb_4/1", "КЛЮЧ", false, "", "", "!Отсутствует открытый текст!"},
+    {"Lb_4/1", "КЛЮЧ", false, "123 !?", "", "!Отсутствует открытый текст!"},
+    {"Lb_4/1", "КЛЮЧ", false, "HELLO", "", "!Отсутствует открытый текст!"},
+    {"Lb_4/1", "КЛЮЧ", true, "", "", "!Empty cipher text"},
+    {"Lb_4/1", "КЛЮЧ", true, "ЪЬЖ ЩПЮ", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_4/1", "КЛЮЧ", true, "ЪЬЖ1", "", "!Неправильный зашифрованный текст!"},
+    {"Lb_1_2_1-4", "3", false, "ПРИВЕТМИР", "", "ИТРРЕИПВМ"},
+    {"Lb_1_2_1-4", "4", false, "Привет, мир! Ёлка", "", "ВИКИМЛРТЁПЕРА"},
+    {"Lb_1_2_1-4", "4", true, "ВМЁИТИЛПЕРКРА", "", "РЛИВКПТМРЕИЁА"},
+    {"Lb_1_2_1-4", "5", true, "ёлка", "", "АКЛЁ"},
+    {"Lb_1_2_1-4", "1", false, "ТЕКСТ", "", "ТЕКСТ"},
+    {"Lb_1_2_1-4", "20", false, "КОРОТКИЙ", "", "ЙИКТОРОК"},
+    {"Lb_1_2_1-4", "20", true, "КОРОТКИЙ", "", "ЙИКТОРОК"},
+    {"Lb_1_2_1-4", "0", false, "ТЕКСТ", "", "!\035" "525@=K9 :;NG: :;NG 4>;65= 1KBL ?>;>68B5;L=K< G8A;><"},
+    {"Lb_1_2_1-4", "-3", false, "ТЕКСТ", "", "!\035" "525@=K9 :;NG: :;NG 4>;65= 1KBL ?>;>68B5;L=K< G8A;><"},
+    {"Lb_1_2_1-4", "3", false, "", "", "!\037CAB>9 B5:AB"},
+    {"Lb_1_2_1-4", "3", false, "HELLO 123", "", "!\022 B5:AB5 =5B @CAA:8E 1C:2"},
+    {"Lb_1_2_1-4", "3", true, "", "", "!\037CAB>9 B5:AB"},
+    {"Lb_1_2_5", "3", false, "ПРИВЕТМИР", "", "ИТРРЕИПВМ"},
+    {"Lb_1_2_5", "4", false, "Привет, мир! Ёлка", "", "ВИКИМЛРТЁПЕРА"},
+    {"Lb_1_2_5", "4", true, "ВМЁИТИЛПЕРКРА", "", "РЛИВКПТМРЕИЁА"},
+    {"Lb_1_2_5", "5", true, "ёлка", "", "АКЛЁ"},
+    {"Lb_1_2_5", "1", false, "ТЕКСТ", "", "ТЕКСТ"},
+    {"Lb_1_2_5", "20", false, "КОРОТКИЙ", "", "ЙИКТОРОК"},
+    {"Lb_1_2_5", "20", true, "КОРОТКИЙ", "", "ЙИКТОРОК"},
+    {"Lb_1_2_5", "0", false, "ТЕКСТ", "", "!\035" "525@=K9 :;NG: :;NG 4>;65= 1KBL ?>;>68B5;L=K< G8A;><"},
+    {"Lb_1_2_5", "-3", false, "ТЕКСТ", "", "!\035" "525@=K9 :;NG: :;NG 4>;65= 1KBL ?>;>68B5;L=K< G8A;><"},
+    {"Lb_1_2_5", "3", false, "", "", "!\037CAB>9 B5:AB"},
+    {"Lb_1_2_5", "3", false, "HELLO 123", "", "!\022 B5:AB5 =5B @CAA:8E 1C:2"},
+    {"Lb_1_2_5", "3", true, "", "", "!\037CAB>9 B5:AB"},
+    {"Lb_2_2", "3", false, "HELLOWORLD", "HELLOWORLD", "LWLROEDOLH"},
+    {"Lb_2_2", "4", false, "Hello World", "Hello World", "rloldWeloH"},
+    {"Lb_2_2", "4", true, "DLOLRLEOWH", "HELLOWORLD", "HELLWLODOR"},
+    {"Lb_2_2", "3", true, "abcdefg", "abcdefg", "gdbfcae"},
+    {"Lb_2_2", "10", false, "HELLOWORLD", "HELLOWORLD", "DLROWOLLEH"},
+    {"Lb_2_2", "11", false, "HELLOWORLD", "HELLOWORLD", "!Некорректный размер ключа"},
+    {"Lb_2_2", "1", false, "HELLO", "HELLO", "!Некорректный размер ключа"},
+    {"Lb_2_2", "0", false, "HELLO", "HELLO", "!Некорректный размер ключа"},
+    {"Lb_2_2", "-3", false, "HELLO", "HELLO", "!Некорректный размер ключа"},
+    {"Lb_2_2", "3", false, "   ", "HELLO", "!Отсутствует открытый текст"},
+    {"Lb_2_2", "3", false, "HELLO!", "HELLO", "!Некорректные символы в строке. Разрешены только латинские буквы (A-Z, a-z)."},
+    {"Lb_2_2", "3", false, "ПРИВЕТ", "HELLO", "!Некорректные символы в строке. Разрешены только латинские буквы (A-Z, a-z)."},
+    {"Lb_2_2", "3", true, "", "HELLO", "!Отсутствует зашифрованный текст"},
+    {"Lb_3_2", "3", false, "HELLOWORLD", "HELLOWORLD", "LWLEORHLOD"},
+    {"Lb_3_2", "4", false, "Hello World", "Hello World", "lrloeWHold"},
+    {"Lb_3_2", "4", true, "LOLRLEOWHD", "HELLOWORLD", "OLLLWEROHD"},
+    {"Lb_3_2", "3", true, "abcdefg", "abcdefg", "ecafdbg"},
+    {"Lb_3_2", "10", false, "HELLOWORLD", "HELLOWORLD", "DLROWOLLEH"},
+    {"Lb_3_2", "11", false, "HELLOWORLD", "HELLOWORLD", "!Ключ некорректного размера"},
+    {"Lb_3_2", "1", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_3_2", "0", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_3_2", "-3", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_3_2", "3", false, "", "HELLO", "!Отсутствует открытый текст!"},
+    {"Lb_3_2", "3", false, "HELLO!", "HELLO", "!В тексте встречены некорректные символы!"},
+    {"Lb_3_2", "3", false, "ПРИВЕТ", "HELLO", "!В тексте встречены некорректные символы!"},
+    {"Lb_3_2", "3", true, "", "HELLO", "!Один из текстов пуст!"},
+    {"Lb_3_2", "3", true, "HEL LO", "HELLOO", "!Некорректные символы в зашифрованном тексте!"},
+    {"Lb_3_2", "3", true, "HELLO", "HELLOO", "!Неправильный зашифрованный текст: HELLO"},
+    {"Lb_3_2", "3", true, "HELLO", "HEL1O", "!Некорректные символы в открытом тексте!"},
+    {"Lb_3_2", "3", true, "LE1LO", "HEL2O", "!Некорректные символы в зашифрованном тексте!"},
+    {"Lb_3_2", "3", true, "LE1LO", "HEL2OO", "!Некорректные символы в зашифрованном тексте!"},
+    {"Lb_4/2", "3", false, "HELLOWORLD", "HELLOWORLD", "LWLEORHLOD"},
+    {"Lb_4/2", "4", false, "Hello World", "Hello World", "lrloeWHold"},
+    {"Lb_4/2", "4", true, "LOLRLEOWHD", "HELLOWORLD", "OLLLWEROHD"},
+    {"Lb_4/2", "3", true, "abcdefg", "abcdefg", "ecafdbg"},
+    {"Lb_4/2", "10", false, "HELLOWORLD", "HELLOWORLD", "DLROWOLLEH"},
+    {"Lb_4/2", "11", false, "HELLOWORLD", "HELLOWORLD", "!Ключ некорректного размера"},
+    {"Lb_4/2", "1", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_4/2", "0", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_4/2", "-3", false, "HELLO", "HELLO", "!Ключ некорректного размера"},
+    {"Lb_4/2", "3", false, "", "HELLO", "!Отсутствует открытый текст!"},
+    {"Lb_4/2", "3", false, "HELLO!", "HELLO", "!В тексте встречены некорректные символы!"},
+    {"Lb_4/2", "3", false, "ПРИВЕТ", "HELLO", "!В тексте встречены некорректные символы!"},
+    {"Lb_4/2", "3", true, "", "HELLO", "!Один из текстов пуст!"},
+    {"Lb_4/2", "3", true, "HEL LO", "HELLOO", "!Некорректные символы в зашифрованном тексте!"},
+    {"Lb_4/2", "3", true, "HELLO", "HELLOO", "!Неправильный зашифрованный текст: HELLO"},
+    {"Lb_4/2", "3", true, "HELLO", "HEL1O", "!Некорректные символы в открытом тексте!"},
+    {"Lb_4/2", "3", true, "LE1LO", "HEL2O", "!Некорректные символы в зашифрованном тексте!"},
+    {"Lb_4/2", "3", true, "LE1LO", "HEL2OO", "!Некорректные символы в зашифрованном тексте!"},
+};
+
+#define FACADE_RU_UP "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"
+#define FACADE_RU FACADE_RU_UP "абвгдеёжзийклмнопрстуфхцчшщъыьэюя"
+#define FACADE_LAT "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+
+static const facadeBulk facadeBulks[] = {
+    {"Lb_1_1", "КЛЮЧ", false, FACADE_RU_UP, 1000, 1, 0x0f626ad6dc11d89full},
+    {"Lb_1_1", "ШИФРГРОНСФЕЛЬДА", true, FACADE_RU_UP, 70001, 2, 0x1bc5de6e542cfd6eull},
+    {"Lb_2_1", "КЛЮЧ", false, FACADE_RU " ,.", 1000, 3, 0x787957c867f2a606ull},
+    {"Lb_2_1", "ШИФРГРОНСФЕЛЬДА", false, FACADE_RU, 70001, 4, 0xc3ad475b6532a6a9ull},
+    {"Lb_2_1", "ключ", true, FACADE_RU, 70001, 5, 0x1551f062a90add8eull},
+    {"Lb_3_1", "КЛЮЧ", false, FACADE_RU " ,.", 1000, 6, 0x008af5c57327ebe3ull},
+    {"Lb_3_1", "ШИФРГРОНСФЕЛЬДА", false, FACADE_RU, 70001, 7, 0xf214121da7275c36ull},
+    {"Lb_3_1", "ключ", true, FACADE_RU_UP, 70001, 8, 0x96a66bfe3432a964ull},
+    {"Lb_4/1", "КЛЮЧ", false, FACADE_RU " ,.", 1000, 9, 0x32bc915f10300f69ull},
+    {"Lb_4/1", "ШИФРГРОНСФЕЛЬДА", false, FACADE_RU, 70001, 10, 0xac9b8750c8bf0198ull},
+    {"Lb_4/1", "ключ", true, FACADE_RU_UP, 70001, 11, 0x8036fc19eb7e3c96ull},
+    {"Lb_1_2_1-4", "3", false, FACADE_RU " ,.!1", 1000, 12, 0x24b5345d57145446ull},
+    {"Lb_1_2_1-4", "64", false, FACADE_RU " ", 70001, 13, 0xa50e30a703cd489bull},
+    {"Lb_1_2_1-4", "1000", true, FACADE_RU, 70001, 14, 0x5e7f48a2f3a4a84full},
+    {"Lb_1_2_5", "3", false, FACADE_RU " ,.!1", 1000, 15, 0xd0e83a144dfe6447ull},
+    {"Lb_1_2_5", "64", false, FACADE_RU " ", 70001, 16, 0x64a773a4269f3018ull},
+    {"Lb_1_2_5", "1000", true, FACADE_RU, 70001, 17, 0x4804b15915ca7e87ull},
+    {"Lb_2_2", "3", false, FACADE_LAT " ", 1000, 18, 0xe51fde76a3674b65ull},
+    {"Lb_2_2", "64", false, FACADE_LAT, 70001, 19, 0x6afa02d8644e3d17ull},
+    {"Lb_2_2", "1000", true, FACADE_LAT, 70001, 20, 0xd6d5a46e514c4084ull},
+    {"Lb_3_2", "3", false, FACADE_LAT " ", 1000, 21, 0xe31340fb03313f9full},
+    {"Lb_3_2", "64", false, FACADE_LAT, 70001, 22, 0xa8854951f098b37cull},
+    {"Lb_3_2", "1000", true, FACADE_LAT, 70001, 23, 0xb147f968daf2c7c8ull},
+    {"Lb_4/2", "3", false, FACADE_LAT " ", 1000, 24, 0x339a03d3ce370eceull},
+    {"Lb_4/2", "64", false, FACADE_LAT, 70001, 25, 0xfbc53dcb7df41ddeull},
+    {"Lb_4/2", "1000", true, FACADE_LAT, 70001, 26, 0x6d608aa3678d9297ull},
+};
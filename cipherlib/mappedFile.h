@@ -0,0 +1,226 @@
+/**
+ * @file mappedFile.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-16
+ * @brief Отображение файлов в память для файлового режима шифров
+ * @details Входной файл отображается только для чтения, выходной создаётся нужного
+ *          размера и отображается для записи, так что ядра шифров работают прямо по
+ *          страницам файлов без промежуточных строк. Страницы подгружаются заранее
+ *          (MAP_POPULATE), чтение отмечается как последовательное (MADV_SEQUENTIAL),
+ *          по запросу включаются большие страницы (MADV_HUGEPAGE; для обычных файлов
+ *          ядро может проигнорировать подсказку). Без POSIX файл читается в память
+ *          целиком и записывается при закрытии.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+/**
+ * @class mappedFile
+ * @brief Файл, отображённый в память (владеет отображением)
+ */
+class mappedFile {
+public:
+    mappedFile() = default;
+    mappedFile(const mappedFile&) = delete;
+    mappedFile& operator=(const mappedFile&) = delete;
+
+    mappedFile(mappedFile&& other) noexcept {
+        swap(other);
+    }
+
+    mappedFile& operator=(mappedFile&& other) noexcept {
+        mappedFile(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~mappedFile() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    /**
+     * @brief Отображает существующий файл для чтения
+     * @param path Путь к файлу
+     * @param hugePages Просить у ядра большие страницы
+     * @throw std::system_error Если файл не открывается или не отображается
+     */
+    static mappedFile openRead(const std::string& path, bool hugePages) {
+        mappedFile f;
+        f.path = path;
+#ifdef MAPPED_FILE_POSIX
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            fail(path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int e = errno;
+            ::close(fd);
+            fail(path, e);
+        }
+        f.length = f.capacity = size_t(st.st_size);
+        try {
+            f.map(fd, PROT_READ, MAP_PRIVATE, hugePages);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        // Отображение остаётся действительным и после закрытия дескриптора
+        ::close(fd);
+#else
+        (void)hugePages;
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            fail(path, ENOENT);
+        f.buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        f.length = f.capacity = f.buffer.size();
+        f.bytes = f.buffer.data();
+#endif
+        return f;
+    }
+
+    /**
+     * @brief Создаёт (или перезаписывает) файл заданного размера и отображает его для записи
+     * @param path Путь к файлу
+     * @param size Размер файла в байтах; итоговый размер можно уменьшить через resize()
+     * @param hugePages Просить у ядра большие страницы
+     * @throw std::system_error Если файл не создаётся или не отображается
+     */
+    static mappedFile create(const std::string& path, size_t size, bool hugePages) {
+        mappedFile f;
+        f.path = path;
+        f.length = f.capacity = size;
+        f.writable = true;
+#ifdef MAPPED_FILE_POSIX
+        f.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (f.fd < 0)
+            fail(path);
+        if (::ftruncate(f.fd, off_t(size)) != 0)
+            fail(path);
+        f.map(f.fd, PROT_READ | PROT_WRITE, MAP_SHARED, hugePages);
+#else
+        (void)hugePages;
+        f.buffer.resize(size);
+        f.bytes = f.buffer.data();
+#endif
+        return f;
+    }
+
+    char* data() {
+        return bytes;
+    }
+
+    const char* data() const {
+        return bytes;
+    }
+
+    /// Текущий размер файла
+    size_t size() const {
+        return length;
+    }
+
+    /**
+     * @brief Уменьшает выходной файл до size байт (применяется при закрытии)
+     */
+    void resize(size_t size) {
+        length = std::min(size, capacity);
+    }
+
+    /**
+     * @brief Снимает отображение; выходной файл обрезается до size()
+     * @throw std::system_error Если файл не удалось обрезать или записать
+     */
+    void close() {
+#ifdef MAPPED_FILE_POSIX
+        if (bytes && capacity)
+            ::munmap(bytes, capacity);
+        bytes = nullptr;
+        if (fd >= 0) {
+            int handle = fd;
+            fd = -1;
+            bool ok = length == capacity || ::ftruncate(handle, off_t(length)) == 0;
+            int e = errno;
+            ok &= ::close(handle) == 0;
+            if (!ok)
+                fail(path, e);
+        }
+#else
+        if (writable) {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out.write(buffer.data(), length))
+                fail(path, EIO);
+        }
+        bytes = nullptr;
+        buffer.clear();
+#endif
+        writable = false;
+    }
+
+private:
+    std::string path;
+    char* bytes = nullptr;
+    size_t length = 0;   ///< Размер файла
+    size_t capacity = 0; ///< Размер отображения
+    bool writable = false;
+#ifdef MAPPED_FILE_POSIX
+    int fd = -1;         ///< Дескриптор выходного файла (нужен для обрезки)
+
+    void map(int handle, int prot, int flags, bool hugePages) {
+        if (capacity == 0)
+            return; // пустой файл не отображается
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void* p = ::mmap(nullptr, capacity, prot, flags, handle, 0);
+        if (p == MAP_FAILED)
+            fail(path);
+        bytes = static_cast<char*>(p);
+        ::madvise(p, capacity, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        if (hugePages)
+            ::madvise(p, capacity, MADV_HUGEPAGE);
+#else
+        (void)hugePages;
+#endif
+    }
+#else
+    std::vector<char> buffer;
+#endif
+
+    [[noreturn]] static void fail(const std::string& path, int e = errno) {
+        throw std::system_error(e, std::generic_category(), path);
+    }
+
+    void swap(mappedFile& other) noexcept {
+        std::swap(path, other.path);
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+        std::swap(capacity, other.capacity);
+        std::swap(writable, other.writable);
+#ifdef MAPPED_FILE_POSIX
+        std::swap(fd, other.fd);
+#else
+        std::swap(buffer, other.buffer);
+#endif
+    }
+};
@@ -0,0 +1,180 @@
+/**
+ * @file perfCounters.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-12-19
+ * @brief Аппаратные счётчики производительности для замеров шифров
+ * @details Счётчики Linux perf_event_open: такты, инструкции, промахи L1D и LLC,
+ *          ошибки предсказания переходов и промахи dTLB. Считаются только события
+ *          пользовательского режима текущего потока, поэтому достаточно
+ *          kernel.perf_event_paranoid <= 2 без дополнительных прав. Каждый счётчик
+ *          открывается отдельно: если ядро, процессор или контейнер не дают какой-то
+ *          из них, остальные продолжают работать, а недоступный просто не выводится.
+ *          Вне Linux все счётчики недоступны.
+ */
+
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#define PERF_COUNTERS_LINUX 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class perfCounters
+ * @brief Набор счётчиков текущего потока (владеет дескрипторами)
+ */
+class perfCounters {
+public:
+    /// Измеряемые события
+    enum event {
+        cycles,       ///< Такты процессора
+        instructions, ///< Выполненные инструкции
+        l1dMisses,    ///< Промахи чтения L1 данных
+        llcMisses,    ///< Промахи последнего уровня кэша
+        branchMisses, ///< Ошибки предсказания переходов
+        dtlbMisses,   ///< Промахи чтения dTLB
+        eventCount    ///< Количество событий
+    };
+
+    /// Показания за интервал start() - stop()
+    struct reading {
+        bool valid[eventCount];   ///< Счётчик открыт и успел поработать
+        double value[eventCount]; ///< Значение с поправкой на мультиплексирование
+    };
+
+    perfCounters() {
+        for (int e = 0; e < eventCount; e++)
+            fd[e] = open(event(e), error[e]);
+    }
+
+    perfCounters(const perfCounters&) = delete;
+    perfCounters& operator=(const perfCounters&) = delete;
+
+    ~perfCounters() {
+#ifdef PERF_COUNTERS_LINUX
+        for (int e = 0; e < eventCount; e++)
+            if (fd[e] >= 0)
+                ::close(fd[e]);
+#endif
+    }
+
+    /**
+     * @brief Имя события в результатах
+     */
+    static const char* name(event e) {
+        static const char* const names[eventCount] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+        };
+        return names[e];
+    }
+
+    /**
+     * @brief Проверяет, открыт ли счётчик
+     */
+    bool available(event e) const {
+        return fd[e] >= 0;
+    }
+
+    /**
+     * @brief Причина, по которой счётчик недоступен (пусто, если он открыт)
+     */
+    const std::string& why(event e) const {
+        return error[e];
+    }
+
+    /**
+     * @brief Обнуляет и запускает все открытые счётчики
+     */
+    void start() {
+#ifdef PERF_COUNTERS_LINUX
+        for (int e = 0; e < eventCount; e++) {
+            if (fd[e] >= 0) {
+                ::ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Останавливает счётчики и возвращает их показания
+     * @details Если ядро делило счётчик с другими событиями (мультиплексирование),
+     *          значение масштабируется на долю времени, когда счётчик работал.
+     */
+    reading stop() {
+        reading r{};
+#ifdef PERF_COUNTERS_LINUX
+        for (int e = 0; e < eventCount; e++)
+            if (fd[e] >= 0)
+                ::ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < eventCount; e++) {
+            uint64_t data[3]; // значение, время включения, время работы
+            if (fd[e] < 0 || ::read(fd[e], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+                continue;
+            r.valid[e] = true;
+            r.value[e] = double(data[0]) * (double(data[1]) / double(data[2]));
+        }
+#endif
+        return r;
+    }
+
+private:
+    int fd[eventCount];
+    std::string error[eventCount];
+
+    static int open(event e, std::string& error) {
+#ifdef PERF_COUNTERS_LINUX
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        auto cache = [](uint64_t id) {
+            return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (e) {
+        case cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case l1dMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case llcMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case branchMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        }
+        int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0)
+            error = std::strerror(errno);
+        return fd;
+#else
+        error = "perf_event_open есть только в Linux";
+        return -1;
+#endif
+    }
+};
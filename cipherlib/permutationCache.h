@@ -0,0 +1,175 @@
+/**
+ * @file permutationCache.h
+ * @author Ваше Имя
+ * @version 1.0
+ * @date 2025-12-09
+ * @brief Потокобезопасный LRU-кэш перестановок маршрутных шифров
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class permutationCache
+ * @brief Ограниченный по памяти кэш перестановок, вытесняющий давно не использованные
+ * @details Перестановка для тройки (ключ, длина, маршрут) хранится массивом позиций:
+ *          символ k переходит в позицию map[k]. Суммарный размер массивов не превышает
+ *          заданной ёмкости; перестановка больше ёмкости строится, но не сохраняется.
+ *          Построение выполняется вне блокировки, поэтому промах в одном потоке не
+ *          задерживает обращения других. Длина текста должна быть меньше 2^32.
+ */
+class permutationCache {
+public:
+    using map = std::shared_ptr<const std::vector<uint32_t>>; ///< Перестановка (общая с кэшем)
+
+    /// Счётчики и заполненность кэша
+    struct stats {
+        size_t hits;    ///< Найдено в кэше
+        size_t misses;  ///< Построено заново
+        size_t entries; ///< Хранится перестановок
+        size_t bytes;   ///< Занято памяти массивами позиций
+    };
+
+    /**
+     * @brief Конструктор
+     * @param capacity Ограничение памяти в байтах
+     */
+    explicit permutationCache(size_t capacity): capacity(capacity) {}
+
+    /**
+     * @brief Возвращает перестановку, при необходимости строя её
+     * @param key Ключ шифра
+     * @param length Длина текста
+     * @param route Номер маршрута
+     * @param index Функция позиции: index(k) - куда переходит символ k
+     * @return Перестановка длины length
+     * @throw std::bad_alloc Если не удалось выделить память
+     */
+    template <class F>
+    map get(size_t key, size_t length, int route, F index)
+    {
+        return getMap(key, length, route, [&](uint32_t* to) {
+            for (size_t i = 0; i < length; i++)
+                to[i] = static_cast<uint32_t>(index(i));
+        });
+    }
+
+    /**
+     * @brief Возвращает перестановку, при необходимости строя её целиком
+     * @param key Ключ шифра
+     * @param length Длина текста
+     * @param route Номер маршрута
+     * @param fill Функция построения: fill(to) записывает length позиций в массив to
+     * @return Перестановка длины length
+     * @throw std::bad_alloc Если не удалось выделить память
+     */
+    template <class F>
+    map getMap(size_t key, size_t length, int route, F fill)
+    {
+        id k {key, length, route};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(k);
+            if (it != entries.end()) {
+                hits++;
+                order.splice(order.begin(), order, it->second);
+                return it->second->second;
+            }
+            misses++;
+        }
+        auto built = std::make_shared<std::vector<uint32_t>>(length);
+        fill(built->data());
+        insert(k, built);
+        return built;
+    }
+
+    /**
+     * @brief Меняет ограничение памяти, вытесняя лишние перестановки
+     * @param bytes Новое ограничение в байтах
+     */
+    void setCapacity(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity = bytes;
+        evict();
+    }
+
+    /// Текущие счётчики
+    stats statistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return {hits, misses, entries.size(), used};
+    }
+
+    /// Удаляет все перестановки и обнуляет счётчики
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.clear();
+        entries.clear();
+        used = hits = misses = 0;
+    }
+
+private:
+    /// Ключ записи
+    struct id {
+        size_t key;
+        size_t length;
+        int route;
+        bool operator==(const id& o) const
+        {
+            return key == o.key && length == o.length && route == o.route;
+        }
+    };
+
+    /// Хеш ключа записи
+    struct idHash {
+        size_t operator()(const id& k) const
+        {
+            size_t h = std::hash<size_t>()(k.key);
+            h = h * 1000003 ^ std::hash<size_t>()(k.length);
+            return h * 1000003 ^ std::hash<int>()(k.route);
+        }
+    };
+
+    using entryList = std::list<std::pair<id, map>>;
+
+    mutable std::mutex mutex; ///< Защищает все поля ниже
+    size_t capacity;          ///< Ограничение памяти
+    size_t used = 0;          ///< Занято памяти
+    size_t hits = 0;          ///< Попадания
+    size_t misses = 0;        ///< Промахи
+    entryList order;          ///< Записи от недавно использованных к давним
+    std::unordered_map<id, entryList::iterator, idHash> entries; ///< Поиск записи по ключу
+
+    /// Сохраняет построенную перестановку, если она помещается
+    void insert(const id& k, const map& m)
+    {
+        size_t bytes = m->size() * sizeof(uint32_t);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes > capacity || entries.count(k))
+            return;
+        order.emplace_front(k, m);
+        entries[k] = order.begin();
+        used += bytes;
+        evict();
+    }
+
+    /// Вытесняет давно не использованные записи до соблюдения ограничения (под блокировкой)
+    void evict()
+    {
+        while (used > capacity && !order.empty()) {
+            used -= order.back().second->size() * sizeof(uint32_t);
+            entries.erase(order.back().first);
+            order.pop_back();
+        }
+    }
+};
@@ -0,0 +1,367 @@
+/**
+ * @file routePolicy.h
+ * @author Ваше Имя
+ * @version 1.0
+ * @date 2025-12-09
+ * @brief Маршруты табличных перестановок как типы-стратегии
+ * @details Текст записывается в таблицу из cols столбцов по строкам; последняя строка
+ *          может быть неполной, её пустые ячейки при чтении пропускаются. Маршрут
+ *          чтения задаётся типом со статической функцией walk(rows, cols, f), которая
+ *          вызывает f(r, c) для всех ячеек таблицы rows x cols в порядке чтения.
+ *          walk встраивается в цикл перестановки, поэтому любой маршрут работает как
+ *          написанный вручную цикл, а новый маршрут не требует нового кода таблицы.
+ *          Для маршрутов по столбцам routeKernel специализирован блочным
+ *          транспонированием из routeTranspose.h и может выполняться в несколько
+ *          потоков по полосам строк (routeParallel).
+ */
+
+#pragma once
+#include "routeTranspose.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace route {
+
+/// Столбцы справа налево, каждый сверху вниз
+struct columnsRightToLeft {
+    static const int id = 0; ///< Номер маршрута в кэше перестановок
+
+    template <class F>
+    static constexpr void walk(size_t rows, size_t cols, F&& f)
+    {
+        for (size_t c = cols; c-- > 0;)
+            for (size_t r = 0; r < rows; r++)
+                f(r, c);
+    }
+};
+
+/// Столбцы справа налево, каждый снизу вверх
+struct columnsBottomUp {
+    static const int id = 1; ///< Номер маршрута в кэше перестановок
+
+    template <class F>
+    static constexpr void walk(size_t rows, size_t cols, F&& f)
+    {
+        for (size_t c = cols; c-- > 0;)
+            for (size_t r = rows; r-- > 0;)
+                f(r, c);
+    }
+};
+
+/// Змейка: столбцы справа налево, первый сверху вниз, следующий снизу вверх и т.д.
+struct snake {
+    static const int id = 2; ///< Номер маршрута в кэше перестановок
+
+    template <class F>
+    static constexpr void walk(size_t rows, size_t cols, F&& f)
+    {
+        bool down = true;
+        for (size_t c = cols; c-- > 0; down = !down) {
+            if (down)
+                for (size_t r = 0; r < rows; r++)
+                    f(r, c);
+            else
+                for (size_t r = rows; r-- > 0;)
+                    f(r, c);
+        }
+    }
+};
+
+/// Спираль по часовой стрелке от левого верхнего угла к центру
+struct spiral {
+    static const int id = 3; ///< Номер маршрута в кэше перестановок
+
+    template <class F>
+    static constexpr void walk(size_t rows, size_t cols, F&& f)
+    {
+        size_t top = 0, bottom = rows, left = 0, right = cols;
+        while (top < bottom && left < right) {
+            for (size_t c = left; c < right; c++)
+                f(top, c);
+            top++;
+            for (size_t r = top; r < bottom; r++)
+                f(r, right - 1);
+            right--;
+            if (top < bottom) {
+                for (size_t c = right; c-- > left;)
+                    f(bottom - 1, c);
+                bottom--;
+            }
+            if (left < right) {
+                for (size_t r = bottom; r-- > top;)
+                    f(r, left);
+                left++;
+            }
+        }
+    }
+};
+
+/// Зигзаг по диагоналям r + c = d, направление чередуется (как в JPEG)
+struct zigzag {
+    static const int id = 4; ///< Номер маршрута в кэше перестановок
+
+    template <class F>
+    static constexpr void walk(size_t rows, size_t cols, F&& f)
+    {
+        if (rows == 0 || cols == 0)
+            return;
+        for (size_t d = 0; d < rows + cols - 1; d++) {
+            size_t low = d < cols ? 0 : d - cols + 1;  // наименьшая строка диагонали
+            size_t high = d < rows ? d : rows - 1;     // наибольшая строка диагонали
+            if (d % 2 == 0)
+                for (size_t r = high + 1; r-- > low;)
+                    f(r, d - r);
+            else
+                for (size_t r = low; r <= high; r++)
+                    f(r, d - r);
+        }
+    }
+};
+
+/**
+ * @brief Номер в кэше перестановок для варианта Route, в котором таблица состоит
+ *        только из полных строк, а остаток текста остаётся на месте
+ * @details При той же длине такая перестановка отличается от перестановки Route по
+ *          всему тексту, поэтому хранится в кэше под своим номером.
+ */
+template <class Route>
+constexpr int fullRowsId = 0x100 + Route::id;
+
+/**
+ * @brief Строит перестановку маршрута: символ k переходит в позицию to[k]
+ * @param to Массив из n позиций
+ * @param n Длина текста
+ * @param cols Количество столбцов
+ */
+template <class Route, class T>
+constexpr void routeMap(T* to, size_t n, size_t cols)
+{
+    size_t p = 0;
+    Route::walk((n + cols - 1) / cols, cols, [&](size_t r, size_t c) {
+        size_t k = r * cols + c;
+        if (k < n)
+            to[k] = static_cast<T>(p++);
+    });
+}
+
+/**
+ * @brief Перестановка маршрута, построенная при компиляции
+ * @details Пример: routeTable<spiral, 12, 4>()[k] - позиция символа k в шифртексте.
+ */
+template <class Route, size_t N, size_t Cols>
+constexpr std::array<size_t, N> routeTable()
+{
+    std::array<size_t, N> to {};
+    routeMap<Route>(to.data(), N, Cols);
+    return to;
+}
+
+/**
+ * @brief Переставляет n символов из in в out обходом Route::walk
+ * @param in Исходный текст
+ * @param out Результат (n символов, не пересекается с in)
+ * @param n Длина текста
+ * @param cols Количество столбцов таблицы
+ * @param inverse true - обратная перестановка (расшифрование)
+ * @param valid Предикат допустимого символа, проверяется в том же проходе
+ * @return true, если все символы допустимы (иначе содержимое out не определено)
+ */
+template <class Route, class T, class F>
+bool routeWalk(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid)
+{
+    size_t p = 0;
+    bool ok = true;
+    Route::walk((n + cols - 1) / cols, cols, [&](size_t r, size_t c) {
+        size_t k = r * cols + c;
+        if (k >= n)
+            return;
+        T x = inverse ? in[p] : in[k];
+        (inverse ? out[k] : out[p]) = x;
+        ok &= valid(x);
+        p++;
+    });
+    return ok;
+}
+
+/**
+ * @brief Перестановка текста по маршруту Route
+ * @details Общий вариант - routeWalk; специализации для маршрутов по столбцам
+ *          используют блочное транспонирование (только для однобайтных символов).
+ */
+template <class Route>
+struct routeKernel {
+    /// Параметры и результат как у routeWalk
+    template <class T, class F>
+    static bool apply(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid)
+    {
+        return routeWalk<Route>(in, out, n, cols, inverse, valid);
+    }
+};
+
+/**
+ * @brief Столбцы справа налево сверху вниз: два транспонирования
+ * @details Столбцы j >= full (full - длина последней строки) высотой rows - 1 стоят в
+ *          начале результата, столбцы j < full высотой rows - за ними.
+ */
+template <>
+struct routeKernel<columnsRightToLeft> {
+    template <class T, class F>
+    static bool apply(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid)
+    {
+        if constexpr (sizeof(T) != 1)
+            return routeWalk<columnsRightToLeft>(in, out, n, cols, inverse, valid);
+        else
+            return applyRows(in, out, n, cols, inverse, valid, 0, (n + cols - 1) / cols);
+    }
+
+    /**
+     * @brief Переставляет только строки таблицы [r0, r1) (однобайтные символы)
+     * @details Строки разных вызовов пишут в непересекающиеся позиции результата,
+     *          поэтому полосы строк можно обрабатывать параллельно.
+     */
+    template <class T, class F>
+    static bool applyRows(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid, size_t r0, size_t r1)
+    {
+        static_assert(sizeof(T) == 1, "applyRows работает с однобайтными символами");
+        if (n == 0 || r0 >= r1)
+            return true;
+        const char* src = reinterpret_cast<const char*>(in);
+        char* dst = reinterpret_cast<char*>(out);
+        auto check = [&](char c) { return valid(T(c)); };
+        size_t rows = (n + cols - 1) / cols;
+        size_t top = rows - 1;
+        size_t full = n - top * cols;
+        size_t left = (cols - full) * top + (full - 1) * rows; // начало столбца full - 1
+        size_t right = (cols - 1 - full) * top;                 // начало столбца full
+        size_t height = r1 - r0;                                // строки левых столбцов
+        size_t rightHeight = std::min(r1, top) > r0 ? std::min(r1, top) - r0 : 0;
+        bool ok = true;
+        if (inverse) {
+            ok &= transposeBytes(src + left + r0, -ptrdiff_t(rows), 1, dst + r0 * cols, cols, 1, full, height, check);
+            if (full < cols)
+                ok &= transposeBytes(src + right + r0, -ptrdiff_t(top), 1, dst + r0 * cols + full, cols, 1,
+                                     cols - full, rightHeight, check);
+        } else {
+            ok &= transposeBytes(src + r0 * cols, cols, 1, dst + left + r0, -ptrdiff_t(rows), 1, height, full, check);
+            if (full < cols)
+                ok &= transposeBytes(src + r0 * cols + full, cols, 1, dst + right + r0, -ptrdiff_t(top), 1,
+                                     rightHeight, cols - full, check);
+        }
+        return ok;
+    }
+};
+
+/**
+ * @brief Столбцы справа налево снизу вверх: два транспонирования и последняя строка
+ */
+template <>
+struct routeKernel<columnsBottomUp> {
+    template <class T, class F>
+    static bool apply(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid)
+    {
+        if constexpr (sizeof(T) != 1)
+            return routeWalk<columnsBottomUp>(in, out, n, cols, inverse, valid);
+        else
+            return applyRows(in, out, n, cols, inverse, valid, 0, (n + cols - 1) / cols);
+    }
+
+    /**
+     * @brief Переставляет только строки таблицы [r0, r1) (однобайтные символы)
+     * @details Строки разных вызовов пишут в непересекающиеся позиции результата.
+     */
+    template <class T, class F>
+    static bool applyRows(const T* in, T* out, size_t n, size_t cols, bool inverse, F valid, size_t r0, size_t r1)
+    {
+        static_assert(sizeof(T) == 1, "applyRows работает с однобайтными символами");
+        if (n == 0 || r0 >= r1)
+            return true;
+        const char* src = reinterpret_cast<const char*>(in);
+        char* dst = reinterpret_cast<char*>(out);
+        auto check = [&](char c) { return valid(T(c)); };
+        size_t rows = (n + cols - 1) / cols;
+        size_t top = rows - 1;
+        size_t full = n - top * cols;
+        size_t height = std::min(r1, top) > r0 ? std::min(r1, top) - r0 : 0; // полные строки полосы
+        bool ok = true;
+
+        // Столбцы 0..full-1 высотой rows стоят в конце результата
+        size_t left = (cols - full) * top + (full - 1) * rows + top - r0;
+        // Столбцы full..cols-1 высотой top стоят в начале результата
+        size_t right = (cols - 1 - full) * top + top - 1 - r0;
+        if (inverse) {
+            ok &= transposeBytes(src + left, -ptrdiff_t(rows), -1, dst + r0 * cols, cols, 1, full, height, check);
+            if (full < cols)
+                ok &= transposeBytes(src + right, -ptrdiff_t(top), -1, dst + r0 * cols + full, cols, 1,
+                                     cols - full, height, check);
+        } else {
+            ok &= transposeBytes(src + r0 * cols, cols, 1, dst + left, -ptrdiff_t(rows), -1, height, full, check);
+            if (full < cols)
+                ok &= transposeBytes(src + r0 * cols + full, cols, 1, dst + right, -ptrdiff_t(top), -1,
+                                     height, cols - full, check);
+        }
+
+        // Последняя строка - нижние элементы левых столбцов
+        if (r1 > top)
+            for (size_t j = 0; j < full; j++) {
+                size_t pos = (cols - full) * top + (full - 1 - j) * rows;
+                size_t k = top * cols + j;
+                char x = inverse ? src[pos] : src[k];
+                (inverse ? dst[k] : dst[pos]) = x;
+                ok &= check(x);
+            }
+        return ok;
+    }
+};
+
+/**
+ * @brief Параллельная перестановка по маршруту по столбцам
+ * @details Таблица делится на полосы строк (по несколько на поток); потоки берут
+ *          следующую свободную полосу из общего счётчика, поэтому поток, закончивший
+ *          раньше, забирает работу у отстающих. Полосы пишут в непересекающиеся части
+ *          результата. Если полос меньше двух, перестановка выполняется в вызывающем
+ *          потоке; если часть потоков не удалось запустить, их полосы обрабатывают
+ *          остальные. Доступно для маршрутов, у которых routeKernel имеет applyRows.
+ * @param threads Количество потоков (0 - по числу ядер)
+ * @return true, если все символы допустимы
+ * @see routeWalk - остальные параметры
+ */
+template <class Route, class F>
+bool routeParallel(const char* in, char* out, size_t n, size_t cols, bool inverse, F valid, unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t rows = n ? (n + cols - 1) / cols : 0;
+    // Несколько полос на поток выравнивают нагрузку; полоса не тоньше плитки транспонирования
+    size_t band = std::max(routeDetail::tile, rows / (size_t(threads) * 4) + 1);
+    size_t bands = (rows + band - 1) / band;
+    if (threads < 2 || bands < 2)
+        return routeKernel<Route>::apply(in, out, n, cols, inverse, valid);
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> ok(true);
+    auto worker = [&] {
+        for (size_t b; (b = next.fetch_add(1)) < bands;)
+            if (!routeKernel<Route>::applyRows(in, out, n, cols, inverse, valid, b * band,
+                                               std::min(rows, (b + 1) * band)))
+                ok = false;
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(std::min<size_t>(threads, bands));
+    try {
+        for (unsigned t = 1; t < std::min<size_t>(threads, bands); t++)
+            workers.emplace_back(worker);
+    } catch (const std::system_error&) {
+        // Поток не запустился: его полосы заберут уже запущенные потоки и вызывающий
+    }
+    worker();
+    for (auto& w : workers)
+        w.join();
+    return ok;
+}
+
+} // namespace route
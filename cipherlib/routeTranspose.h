@@ -0,0 +1,178 @@
+/**
+ * @file routeTranspose.h
+ * @author Ваше Имя
+ * @version 1.0
+ * @date 2025-12-09
+ * @brief Перестановки для маршрутных шифров: блочное транспонирование и перестановка на месте
+ * @details Матрица обходится плитками 64x64 (для узких таблиц - полосами того же
+ *          объёма), чтобы источник и приёмник плитки помещались в L1 при любой
+ *          ширине таблицы. Внутри плитки блоки 16x16 транспонируются SSE2
+ *          (4 раунда распаковок), остатки - поэлементно.
+ *          Шаги задаются со знаком, поэтому чтение столбцов справа налево и снизу
+ *          вверх выражается отрицательным шагом без отдельного прохода.
+ *          Для текстов, которым не хватает памяти на вторую копию, есть перестановка
+ *          на месте по циклам с битовым массивом пройденных позиций.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace routeDetail {
+
+/// Сторона плитки, обрабатываемой целиком в кэше
+const size_t tile = 64;
+
+/**
+ * @brief Поэлементное транспонирование прямоугольника [r0, r1) x [c0, c1)
+ */
+inline void transposeScalar(const char* src, ptrdiff_t srcRow, ptrdiff_t srcCol, char* dst, ptrdiff_t dstRow,
+                            ptrdiff_t dstCol, size_t r0, size_t r1, size_t c0, size_t c1)
+{
+    for (size_t c = c0; c < c1; c++) {
+        const char* s = src + ptrdiff_t(r0) * srcRow + ptrdiff_t(c) * srcCol;
+        char* d = dst + ptrdiff_t(c) * dstRow + ptrdiff_t(r0) * dstCol;
+        for (size_t r = r0; r < r1; r++, s += srcRow, d += dstCol)
+            *d = *s;
+    }
+}
+
+#ifdef __SSE2__
+/**
+ * @brief Транспонирует блок 16x16 с началом (r0, c0)
+ * @details Шаги по строке источника и по столбцу приёмника равны +-1. Отрицательный
+ *          шаг учитывается порядком загрузки строк и сохранения столбцов, так что
+ *          переворачивать байты внутри регистров не нужно.
+ */
+inline void transposeTile16(const char* src, ptrdiff_t srcRow, ptrdiff_t srcCol, char* dst, ptrdiff_t dstRow,
+                            ptrdiff_t dstCol, size_t r0, size_t c0)
+{
+    __m128i v[16];
+    for (int k = 0; k < 16; k++) {
+        size_t r = r0 + (dstCol > 0 ? k : 15 - k);
+        const char* s = src + ptrdiff_t(r) * srcRow + ptrdiff_t(c0) * srcCol - (srcCol > 0 ? 0 : 15);
+        v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    }
+    // Каждый раунд сдвигает номер строки на бит в номер байта и обратно: после 4 раундов
+    // байт m вектора k оказывается байтом k вектора m
+    for (int round = 0; round < 4; round++) {
+        __m128i t[16];
+        for (int i = 0; i < 8; i++) {
+            t[2 * i] = _mm_unpacklo_epi8(v[i], v[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(v[i], v[i + 8]);
+        }
+        std::copy(t, t + 16, v);
+    }
+    for (int m = 0; m < 16; m++) {
+        size_t c = c0 + (srcCol > 0 ? m : 15 - m);
+        char* d = dst + ptrdiff_t(c) * dstRow + ptrdiff_t(r0) * dstCol - (dstCol > 0 ? 0 : 15);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), v[m]);
+    }
+}
+#endif
+
+} // namespace routeDetail
+
+/**
+ * @brief Транспонирует матрицу байт: dst[c * dstRow + r * dstCol] = src[r * srcRow + c * srcCol]
+ * @details Каждая записанная плитка, пока она в L1, проверяется предикатом valid,
+ *          так что проверка символов не требует отдельного прохода по тексту.
+ * @param src Элемент (0, 0) источника
+ * @param srcRow Шаг между строками источника
+ * @param srcCol Шаг между столбцами источника
+ * @param dst Элемент (0, 0) приёмника
+ * @param dstRow Шаг между строками приёмника (столбцами источника)
+ * @param dstCol Шаг между столбцами приёмника (строками источника)
+ * @param rows Количество строк источника
+ * @param cols Количество столбцов источника
+ * @param valid Предикат допустимого байта
+ * @return true, если все байты допустимы
+ */
+template <class F>
+bool transposeBytes(const char* src, ptrdiff_t srcRow, ptrdiff_t srcCol, char* dst, ptrdiff_t dstRow,
+                    ptrdiff_t dstCol, size_t rows, size_t cols, F valid)
+{
+    using namespace routeDetail;
+    bool ok = true;
+    // Узкая таблица обрабатывается полосами из большего числа строк, чтобы
+    // полоса по-прежнему занимала около tile * tile байт
+    const size_t rowTile = std::max(tile, tile * tile / std::max<size_t>(cols, 1) / 16 * 16);
+    for (size_t r0 = 0; r0 < rows; r0 += rowTile)
+        for (size_t c0 = 0; c0 < cols; c0 += tile) {
+            size_t r1 = std::min(rows, r0 + rowTile);
+            size_t c1 = std::min(cols, c0 + tile);
+            size_t r = r0;
+#ifdef __SSE2__
+            if ((srcCol == 1 || srcCol == -1) && (dstCol == 1 || dstCol == -1))
+                for (; r + 16 <= r1; r += 16) {
+                    size_t c = c0;
+                    for (; c + 16 <= c1; c += 16)
+                        transposeTile16(src, srcRow, srcCol, dst, dstRow, dstCol, r, c);
+                    transposeScalar(src, srcRow, srcCol, dst, dstRow, dstCol, r, r + 16, c, c1);
+                }
+#endif
+            transposeScalar(src, srcRow, srcCol, dst, dstRow, dstCol, r, r1, c0, c1);
+            for (size_t c = c0; c < c1; c++) {
+                const char* d = dst + ptrdiff_t(c) * dstRow + ptrdiff_t(r0) * dstCol;
+                for (size_t k = r0; k < r1; k++, d += dstCol)
+                    ok &= valid(*d);
+            }
+        }
+    return ok;
+}
+
+/**
+ * @brief Транспонирует матрицу байт без проверки (параметры как у варианта с предикатом)
+ */
+inline void transposeBytes(const char* src, ptrdiff_t srcRow, ptrdiff_t srcCol, char* dst, ptrdiff_t dstRow,
+                           ptrdiff_t dstCol, size_t rows, size_t cols)
+{
+    transposeBytes(src, srcRow, srcCol, dst, dstRow, dstCol, rows, cols, [](char) { return true; });
+}
+
+/**
+ * @brief Переставляет байты на месте, следуя циклам перестановки
+ * @details Пройденные позиции отмечаются в битовом массиве, поэтому дополнительная
+ *          память составляет n / 8 байт вместо копии текста.
+ * @param data Текст
+ * @param n Длина текста
+ * @param index Перестановка: байт из позиции k переходит в позицию index(k)
+ * @param inverse true - применить обратную перестановку
+ * @throw std::bad_alloc Если не удалось выделить битовый массив
+ */
+template <class F>
+void permuteInPlace(char* data, size_t n, F index, bool inverse)
+{
+    std::vector<uint64_t> visited((n + 63) / 64);
+    for (size_t s = 0; s < n; s++) {
+        uint64_t word = visited[s / 64];
+        if (word == ~uint64_t(0)) {
+            s |= 63; // все позиции слова уже на месте
+            continue;
+        }
+        if (word >> (s % 64) & 1)
+            continue;
+        size_t k = s;
+        char carry = data[s];
+        for (;;) {
+            visited[k / 64] |= uint64_t(1) << (k % 64);
+            size_t next = index(k);
+            if (inverse) {
+                // data[k] = data[index(k)] по всему циклу
+                data[k] = next == s ? carry : data[next];
+            } else {
+                // data[index(k)] = data[k] по всему циклу
+                std::swap(carry, data[next]);
+            }
+            if (next == s)
+                break;
+            k = next;
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * @file shiftKernel.cpp
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Реализация ядра сдвига Гронсфельда с выбором набора инструкций
+ */
+
+#include "shiftKernel.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHIFT_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const unsigned char alphaSize = 33; ///< Модуль сдвига (размер алфавита)
+
+/**
+ * @brief Скалярный сдвиг без деления: фаза ключа и модуль ведутся условным вычитанием
+ */
+void shiftScalar(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase)
+{
+    for (size_t i = 0; i < n; i++) {
+        unsigned v = data[i] + keyStream[phase];
+        data[i] = static_cast<unsigned char>(v >= alphaSize ? v - alphaSize : v);
+        if (++phase == keyLen)
+            phase = 0;
+    }
+}
+
+#ifdef SHIFT_KERNEL_X86
+__attribute__((target("sse4.2")))
+void shiftSse42(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase)
+{
+    const size_t step = 16 % keyLen;
+    const __m128i mod = _mm_set1_epi8(alphaSize);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(keyStream + phase)));
+        v = _mm_min_epu8(v, _mm_sub_epi8(v, mod));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), v);
+        phase += step;
+        if (phase >= keyLen)
+            phase -= keyLen;
+    }
+    shiftScalar(data + i, n - i, keyStream, keyLen, phase);
+}
+
+__attribute__((target("avx2")))
+void shiftAvx2(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase)
+{
+    const size_t step = 32 % keyLen;
+    const __m256i mod = _mm256_set1_epi8(alphaSize);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keyStream + phase)));
+        v = _mm256_min_epu8(v, _mm256_sub_epi8(v, mod));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), v);
+        phase += step;
+        if (phase >= keyLen)
+            phase -= keyLen;
+    }
+    shiftSse42(data + i, n - i, keyStream, keyLen, phase);
+}
+#endif
+
+} // namespace
+
+shiftLevel bestShiftLevel()
+{
+    static const shiftLevel level = shiftLevelSupported(shiftLevel::avx2) ? shiftLevel::avx2 :
+                                    shiftLevelSupported(shiftLevel::sse42) ? shiftLevel::sse42 :
+                                    shiftLevel::scalar;
+    return level;
+}
+
+bool shiftLevelSupported(shiftLevel level)
+{
+#ifdef SHIFT_KERNEL_X86
+    __builtin_cpu_init();
+    switch (level) {
+    case shiftLevel::avx2:
+        return __builtin_cpu_supports("avx2");
+    case shiftLevel::sse42:
+        return __builtin_cpu_supports("sse4.2");
+    default:
+        return true;
+    }
+#else
+    return level == shiftLevel::scalar;
+#endif
+}
+
+std::vector<unsigned char> makeKeyStream(const std::vector<int>& key, bool inverse)
+{
+    std::vector<unsigned char> stream(key.size() + 31);
+    for (size_t i = 0; i < stream.size(); i++) {
+        int k = key[i % key.size()];
+        stream[i] = static_cast<unsigned char>(inverse ? (alphaSize - k) % alphaSize : k);
+    }
+    return stream;
+}
+
+void shiftAdd(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase,
+              shiftLevel level)
+{
+#ifdef SHIFT_KERNEL_X86
+    if (level == shiftLevel::avx2)
+        return shiftAvx2(data, n, keyStream, keyLen, phase);
+    if (level == shiftLevel::sse42)
+        return shiftSse42(data, n, keyStream, keyLen, phase);
+#endif
+    shiftScalar(data, n, keyStream, keyLen, phase);
+}
+
+void shiftLetters(int* data, size_t n, const std::vector<int>& key, bool inverse)
+{
+    if (n == 0)
+        return;
+    const std::vector<unsigned char> stream = makeKeyStream(key, inverse);
+    const shiftLevel level = bestShiftLevel();
+    unsigned char block[4096];
+    size_t phase = 0;
+    for (size_t i = 0; i < n; i += sizeof block) {
+        size_t count = std::min(sizeof block, n - i);
+        std::copy(data + i, data + i + count, block);
+        shiftAdd(block, count, stream.data(), key.size(), phase, level);
+        std::copy(block, block + count, data + i);
+        phase = (phase + count) % key.size();
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file shiftKernel.h
+ * @author Никита Седнёв
+ * @version 1.0
+ * @date 2025-11-27
+ * @brief Векторизованное ядро сдвига Гронсфельда над номерами букв
+ * @details Номера букв хранятся по одному байту. Ключ разворачивается в поток
+ *          keyStream длиной keyLen + 31, чтобы любое окно из 32 байт начиная с
+ *          позиции фазы читалось одной загрузкой. Модуль 33 берётся условным
+ *          вычитанием. Реализация (скалярная, SSE4.2 или AVX2) выбирается
+ *          во время выполнения по cpuid.
+ */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @enum shiftLevel
+ * @brief Набор инструкций, используемый ядром сдвига
+ */
+enum class shiftLevel {
+    scalar, ///< Переносимая скалярная реализация
+    sse42,  ///< 16 байт за шаг
+    avx2    ///< 32 байта за шаг
+};
+
+/**
+ * @brief Определяет лучший доступный на процессоре набор инструкций
+ * @return Уровень, определённый один раз при первом вызове
+ */
+shiftLevel bestShiftLevel();
+
+/**
+ * @brief Проверяет, поддерживается ли уровень текущим процессором
+ * @param level Проверяемый уровень
+ * @return true, если ядро данного уровня можно вызывать
+ */
+bool shiftLevelSupported(shiftLevel level);
+
+/**
+ * @brief Разворачивает ключ в поток для ядра сдвига
+ * @param key Ключ в числовом виде (значения 0..32)
+ * @param inverse true для потока расшифрования (33 - k) mod 33
+ * @return Поток длиной key.size() + 31
+ */
+std::vector<unsigned char> makeKeyStream(const std::vector<int>& key, bool inverse);
+
+/**
+ * @brief Сдвигает номера букв: data[i] = (data[i] + keyStream[(phase + i) % keyLen]) % 33
+ * @param data Номера букв (0..32), изменяются на месте
+ * @param n Количество номеров
+ * @param keyStream Поток ключа из makeKeyStream()
+ * @param keyLen Длина исходного ключа
+ * @param phase Начальная позиция в ключе (меньше keyLen)
+ * @param level Используемый набор инструкций
+ */
+void shiftAdd(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase,
+              shiftLevel level);
+
+/**
+ * @brief Сдвигает номера букв лучшим доступным ядром
+ * @see shiftAdd(unsigned char*, size_t, const unsigned char*, size_t, size_t, shiftLevel)
+ */
+inline void shiftAdd(unsigned char* data, size_t n, const unsigned char* keyStream, size_t keyLen, size_t phase)
+{
+    shiftAdd(data, n, keyStream, keyLen, phase, bestShiftLevel());
+}
+
+/**
+ * @brief Сдвигает номера букв, хранящиеся в int, лучшим доступным ядром
+ * @details Для классов, которые держат текст в std::vector<int>: номера блоками
+ *          переносятся в байтовый буфер на стеке и сдвигаются shiftAdd. Результат
+ *          совпадает с data[i] = (data[i] +- key[i % key.size()]) mod 33.
+ * @param data Номера букв (0..32), изменяются на месте
+ * @param n Количество номеров
+ * @param key Ключ в числовом виде (значения 0..32)
+ * @param inverse true - сдвиг назад (расшифрование)
+ */
+void shiftLetters(int* data, size_t n, const std::vector<int>& key, bool inverse);